@@ -0,0 +1,71 @@
+// bench/column_sweep.cpp
+//
+// Sweeps a large colonist column with 4 KiB pages and with huge pages and
+// reports the THP coverage the kernel actually gave us.
+//   ./bench_column_sweep [colonists=16000000] [passes=5]
+#include "sim/World.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+double now_s() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+struct Result {
+    double seq_ms;     // linear sweep, like system_colonist_needs
+    double gather_ms;  // strided gather: one element per page, TLB-bound
+    double thp;
+    int64_t sink;
+};
+
+Result run(mars::HugePageMode mode, size_t n, int passes) {
+    mars::set_huge_page_mode(mode);
+    sim::Column<sim::Colonist> col(n);
+    for (size_t i = 0; i < n; ++i) col[i] = {static_cast<uint32_t>(i), 20000, 0, 0, 293'000};
+
+    Result r{};
+    const double t0 = now_s();
+    for (int p = 0; p < passes; ++p) {
+        for (auto& c : col) { c.oxygen_mg -= 5; if (c.oxygen_mg < 0) c.oxygen_mg = 0; }
+    }
+    const double t1 = now_s();
+    // Visit elements in a page-hopping order so each access needs a new
+    // translation: stride of ~1 page with a large odd multiplier.
+    const size_t stride = 4099 / sizeof(sim::Colonist) * 97 + 1;
+    int64_t acc = 0;
+    for (int p = 0; p < passes; ++p) {
+        size_t idx = 0;
+        for (size_t i = 0; i < n; ++i) { acc += col[idx].oxygen_mg; idx += stride; if (idx >= n) idx -= n; }
+    }
+    const double t2 = now_s();
+
+    r.seq_ms    = (t1 - t0) * 1e3 / passes;
+    r.gather_ms = (t2 - t1) * 1e3 / passes;
+    r.thp       = mars::thp_coverage(col.data(), n * sizeof(sim::Colonist)).fraction();
+    r.sink      = acc;
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t n   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16'000'000;
+    const int passes = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    const Result base = run(mars::HugePageMode::Off, n, passes);
+    const Result thp  = run(mars::HugePageMode::Transparent, n, passes);
+
+    std::printf("colonists=%zu column=%.1f MiB passes=%d\n", n,
+                static_cast<double>(n * sizeof(sim::Colonist)) / (1 << 20), passes);
+    std::printf("%-12s %10s %10s %8s\n", "mode", "sweep ms", "gather ms", "THP");
+    std::printf("%-12s %10.2f %10.2f %7.1f%%\n", "4k pages", base.seq_ms, base.gather_ms, base.thp * 100);
+    std::printf("%-12s %10.2f %10.2f %7.1f%%\n", "thp", thp.seq_ms, thp.gather_ms, thp.thp * 100);
+    std::printf("speedup: sweep %.2fx gather %.2fx  (sink %lld)\n",
+                base.seq_ms / thp.seq_ms, base.gather_ms / thp.gather_ms,
+                static_cast<long long>(base.sink + thp.sink));
+    return 0;
+}
@@ -0,0 +1,72 @@
+// bench/command_queue.cpp
+//
+// CommandQueue (timing wheel) against the std::multimap it replaced: AI
+// players keep `pending` orders in flight, each drained order resubmitted
+// 1..horizon hours ahead.
+//   ./bench_command_queue [pending=1000000] [hours=20000] [horizon=5000]
+#include "core/command.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+namespace {
+
+double now_s() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+struct MapQueue {
+    std::multimap<Hours, Command> pending;
+    void submit(const Command& c) { pending.emplace(c.hour, c); }
+    template <class Fn>
+    void drain_for_hour(Hours h, Fn&& apply) {
+        auto range = pending.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it) apply(it->second);
+        pending.erase(range.first, range.second);
+    }
+};
+
+struct Result { double seconds; long applied; long long sum; };
+
+template <class Q>
+Result run(size_t pending, Hours hours, uint32_t horizon) {
+    Q q;
+    uint32_t s = 12345;
+    auto ahead = [&] {
+        s = s * 1664525u + 1013904223u;
+        return static_cast<Hours>(1 + (s >> 8) % horizon);
+    };
+    for (size_t i = 0; i < pending; ++i) q.submit(Command{ahead(), CommandType::Build, static_cast<int>(i)});
+
+    long applied = 0;
+    long long sum = 0;
+    const double t0 = now_s();
+    for (Hours h = 0; h < hours; ++h) {
+        q.drain_for_hour(h, [&](const Command& c) {
+            ++applied;
+            sum += c.a;
+            q.submit(Command{h + ahead(), c.type, c.a});
+        });
+    }
+    return {now_s() - t0, applied, sum};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t pending   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const Hours hours      = argc > 2 ? std::atoll(argv[2]) : 20000;
+    const uint32_t horizon = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 5000;
+
+    const Result m = run<MapQueue>(pending, hours, horizon);
+    const Result w = run<CommandQueue>(pending, hours, horizon);
+
+    std::printf("pending=%zu hours=%lld horizon=%u\n", pending, static_cast<long long>(hours), horizon);
+    std::printf("%-10s %10s %12s\n", "queue", "ns/order", "applied");
+    std::printf("%-10s %10.1f %12ld\n", "multimap", m.seconds * 1e9 / double(m.applied), m.applied);
+    std::printf("%-10s %10.1f %12ld\n", "wheel", w.seconds * 1e9 / double(w.applied), w.applied);
+    std::printf("(same orders: %s)\n", m.applied == w.applied && m.sum == w.sum ? "yes" : "NO");
+    return 0;
+}
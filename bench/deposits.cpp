@@ -0,0 +1,98 @@
+// bench/deposits.cpp
+//
+// "Best site" search over a square around the colony: scalar sample() per
+// cell, sample_row() per row, and Field's cached tiles (cold, then warm),
+// plus random richness lookups in the same area.
+//   ./bench_deposits [radius=1024] [lookups=4000000]
+#include "systems/deposits.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+double now_s() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+namespace dp = mars::deposits;
+
+struct Best { int32_t x, y; float v; };
+
+Best scan_scalar(const dp::Params& p, int32_t r) {
+    Best b{0, 0, -1.0f};
+    for (int32_t y = -r; y < r; ++y) {
+        for (int32_t x = -r; x < r; ++x) {
+            const float v = dp::sample(p, dp::Resource::Metals, x, y);
+            if (v > b.v) b = Best{x, y, v};
+        }
+    }
+    return b;
+}
+
+Best scan_rows(const dp::Params& p, int32_t r) {
+    Best b{0, 0, -1.0f};
+    std::vector<float> row(static_cast<size_t>(2 * r));
+    for (int32_t y = -r; y < r; ++y) {
+        dp::sample_row(p, dp::Resource::Metals, -r, y, row.size(), row.data());
+        for (size_t i = 0; i < row.size(); ++i) {
+            if (row[i] > b.v) b = Best{-r + static_cast<int32_t>(i), y, row[i]};
+        }
+    }
+    return b;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int32_t r       = argc > 1 ? std::atoi(argv[1]) : 1024;
+    const long    lookups = argc > 2 ? std::atol(argv[2]) : 4000000;
+
+    dp::Params p;
+    p.seed = 2024;
+    const size_t side  = static_cast<size_t>(2 * r) / dp::Field::kTileSize + 2;
+    dp::Field field(p, side * side);
+    const double cells = 4.0 * r * r;
+
+    double t0 = now_s();
+    const Best a = scan_scalar(p, r);
+    const double scalar = now_s() - t0;
+
+    t0 = now_s();
+    const Best b = scan_rows(p, r);
+    const double rows = now_s() - t0;
+
+    t0 = now_s();
+    const dp::Site cold = field.best_site(dp::Resource::Metals, -r, -r, r, r);
+    const double coldS = now_s() - t0;
+
+    t0 = now_s();
+    const dp::Site warm = field.best_site(dp::Resource::Metals, -r, -r, r, r);
+    const double warmS = now_s() - t0;
+
+    uint32_t s = 12345;
+    double sum = 0.0;
+    t0 = now_s();
+    for (long i = 0; i < lookups; ++i) {
+        s = s * 1664525u + 1013904223u;
+        const int32_t x = static_cast<int32_t>((s >> 8) % static_cast<uint32_t>(2 * r)) - r;
+        s = s * 1664525u + 1013904223u;
+        const int32_t y = static_cast<int32_t>((s >> 8) % static_cast<uint32_t>(2 * r)) - r;
+        sum += field.richness(dp::Resource::Ice, x, y);
+    }
+    const double lookupS = now_s() - t0;
+
+    std::printf("radius=%d cells=%.0f tiles=%zu\n", r, cells, field.cachedTiles());
+    std::printf("%-16s %12s\n", "search", "ns/cell");
+    std::printf("%-16s %12.2f\n", "sample()", scalar * 1e9 / cells);
+    std::printf("%-16s %12.2f\n", "sample_row()", rows * 1e9 / cells);
+    std::printf("%-16s %12.2f\n", "Field cold", coldS * 1e9 / cells);
+    std::printf("%-16s %12.4f\n", "Field warm", warmS * 1e9 / cells);
+    std::printf("richness lookup: %.1f ns (sum %.1f)\n", lookupS * 1e9 / double(lookups), sum);
+    std::printf("(same site: %s)\n",
+                a.x == b.x && a.y == b.y && a.x == cold.x && a.y == cold.y && warm.x == cold.x && warm.y == cold.y
+                    ? "yes" : "NO");
+    return 0;
+}
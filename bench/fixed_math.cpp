@@ -0,0 +1,73 @@
+// bench/fixed_math.cpp
+//
+// fixed_math batch functions on FP against libm on double.
+//   ./bench_fixed_math [elements=4096] [passes=500]
+#include "fixed_math.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+double now_s() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+template <class F>
+double ns_per(size_t n, int passes, F&& body) {
+    const double t0 = now_s();
+    for (int p = 0; p < passes; ++p) body();
+    return (now_s() - t0) * 1e9 / (double(n) * passes);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t n   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+    const int passes = argc > 2 ? std::atoi(argv[2]) : 500;
+
+    std::vector<double> xd(n), yd(n), od(n);
+    std::vector<FP> xf(n), yf(n), of(n);
+    uint32_t s = 7;
+    for (size_t i = 0; i < n; ++i) {
+        s = s * 1664525u + 1013904223u;
+        xd[i] = (s >> 8) / double(1u << 24) * 20.0 - 10.0;
+        s = s * 1664525u + 1013904223u;
+        yd[i] = (s >> 8) / double(1u << 24) * 20.0 - 10.0;
+        xf[i] = FP::fromDouble(xd[i]);
+        yf[i] = FP::fromDouble(yd[i]);
+    }
+
+    double sink = 0.0;
+    auto libm = [&](double (*f)(double), const std::vector<double>& in) {
+        return ns_per(n, passes, [&] { for (size_t i = 0; i < n; ++i) od[i] = f(in[i]); sink += od[n / 2]; });
+    };
+    auto fixed = [&](void (*f)(std::size_t, const FP*, FP*), const std::vector<FP>& in) {
+        return ns_per(n, passes, [&] { f(n, in.data(), of.data()); sink += of[n / 2].toDouble(); });
+    };
+
+    std::vector<double> sq(n);
+    std::vector<FP> sqf(n);
+    for (size_t i = 0; i < n; ++i) { sq[i] = std::fabs(xd[i]) * 1e3; sqf[i] = FP::fromDouble(sq[i]); }
+
+    std::printf("elements=%zu passes=%d  (ns per element)\n", n, passes);
+    std::printf("%-8s %10s %10s\n", "fn", "libm", "fixed");
+    std::printf("%-8s %10.2f %10.2f\n", "sin", libm(std::sin, xd), fixed(fixed_sin<FP>, xf));
+    std::printf("%-8s %10.2f %10.2f\n", "cos", libm(std::cos, xd), fixed(fixed_cos<FP>, xf));
+    std::printf("%-8s %10.2f %10.2f\n", "exp", libm(std::exp, xd), fixed(fixed_exp<FP>, xf));
+    std::printf("%-8s %10.2f %10.2f\n", "sqrt", libm(std::sqrt, sq), fixed(fixed_sqrt<FP>, sqf));
+    const double at_d = ns_per(n, passes, [&] {
+        for (size_t i = 0; i < n; ++i) od[i] = std::atan2(yd[i], xd[i]);
+        sink += od[n / 2];
+    });
+    const double at_f = ns_per(n, passes, [&] {
+        fixed_atan2(n, yf.data(), xf.data(), of.data());
+        sink += of[n / 2].toDouble();
+    });
+    std::printf("%-8s %10.2f %10.2f\n", "atan2", at_d, at_f);
+    std::printf("(sink %.3f)\n", sink);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// bench/fixed_point.cpp
+//
+// The FixedPoint array kernels against the same loops over double.
+//   ./bench_fixed_point [elements=65536] [passes=2000]
+#include "fixed_point.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+double now_s() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+struct Times { double add, mul, clamp; };
+
+// Values in [-8, 8): products stay in range for every type below.
+template <class T>
+std::vector<T> fill(size_t n, uint32_t seed, T (*conv)(double)) {
+    std::vector<T> v(n);
+    for (auto& x : v) {
+        seed = seed * 1664525u + 1013904223u;
+        x = conv((seed >> 8) / double(1u << 24) * 16.0 - 8.0);
+    }
+    return v;
+}
+
+double as_double(double x) { return x; }
+template <class Fx> double value(Fx x) { return x.toDouble(); }
+
+Times run_double(size_t n, int passes, double& sink) {
+    auto a = fill<double>(n, 1, as_double), b = fill<double>(n, 2, as_double), out(a);
+    Times t{};
+    double t0 = now_s();
+    for (int p = 0; p < passes; ++p) for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+    t.add = now_s() - t0; sink += out[n / 2];
+    t0 = now_s();
+    for (int p = 0; p < passes; ++p) for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+    t.mul = now_s() - t0; sink += out[n / 3];
+    t0 = now_s();
+    for (int p = 0; p < passes; ++p) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] < -2.0 ? -2.0 : a[i] > 3.0 ? 3.0 : a[i];
+    }
+    t.clamp = now_s() - t0; sink += out[n / 5];
+    return t;
+}
+
+template <class Fx>
+Times run_fixed(size_t n, int passes, double& sink) {
+    auto conv = [](double x) { return Fx::fromDouble(x); };
+    auto a = fill<Fx>(n, 1, +conv), b = fill<Fx>(n, 2, +conv), out(a);
+    const Fx lo = Fx::fromInt(-2), hi = Fx::fromInt(3);
+    Times t{};
+    double t0 = now_s();
+    for (int p = 0; p < passes; ++p) fixed_add(n, a.data(), b.data(), out.data());
+    t.add = now_s() - t0; sink += value(out[n / 2]);
+    t0 = now_s();
+    for (int p = 0; p < passes; ++p) fixed_mul(n, a.data(), b.data(), out.data());
+    t.mul = now_s() - t0; sink += value(out[n / 3]);
+    t0 = now_s();
+    for (int p = 0; p < passes; ++p) fixed_clamp(n, a.data(), lo, hi, out.data());
+    t.clamp = now_s() - t0; sink += value(out[n / 5]);
+    return t;
+}
+
+void row(const char* name, Times t, size_t n, int passes) {
+    const double k = 1e9 / (double(n) * passes);
+    std::printf("%-10s %8.3f %8.3f %8.3f\n", name, t.add * k, t.mul * k, t.clamp * k);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t n   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 65536;
+    const int passes = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+    double sink = 0.0;
+    const Times d   = run_double(n, passes, sink);
+    const Times q16 = run_fixed<FixedPoint<int32_t, 16>>(n, passes, sink);
+    const Times fp  = run_fixed<FP>(n, passes, sink);
+    const Times q32 = run_fixed<FixedPoint<int64_t, 32>>(n, passes, sink);
+
+    std::printf("elements=%zu passes=%d  (ns per element)\n", n, passes);
+    std::printf("%-10s %8s %8s %8s\n", "type", "add", "mul", "clamp");
+    row("double", d, n, passes);
+    row("Q15.16", q16, n, passes);
+    row("FP Q47.16", fp, n, passes);
+    row("Q31.32", q32, n, passes);
+    std::printf("(sink %.3f)\n", sink);
+    return 0;
+}
@@ -0,0 +1,104 @@
+// bench/power_fixed.cpp
+//
+// Cost of power::step per battery in double and in FP (fixed_point.h), one
+// battery at a time and through step_batch.
+//   ./bench_power_fixed [batteries=4096] [steps=2000]
+#include "systems/power_system.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace mars::power;
+
+namespace {
+
+double now_s() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+// Deterministic mix of charging, discharging and starved batteries.
+template <class T>
+struct Columns {
+    std::vector<T> stored, cap, prod, crit, noncrit, dt, eff, in, out, unmet;
+
+    explicit Columns(size_t n, T (*conv)(double))
+        : stored(n), cap(n), prod(n), crit(n), noncrit(n), dt(n), eff(n), in(n), out(n), unmet(n) {
+        uint32_t x = 12345;
+        auto next = [&x] { x = x * 1664525u + 1013904223u; return (x >> 8) / double(1u << 24); };
+        for (size_t i = 0; i < n; ++i) {
+            const double c = 5'000.0 + next() * 95'000.0;
+            cap[i]     = conv(c);
+            stored[i]  = conv(next() * c);
+            prod[i]    = conv(next() * 30'000.0);
+            crit[i]    = conv(next() * 15'000.0);
+            noncrit[i] = conv(next() * 10'000.0);
+            dt[i]      = conv(1.0 / 60.0);
+        }
+    }
+};
+
+double to_double(double v) { return v; }
+FP     to_fixed(double v)  { return FP::fromDouble(v); }
+double value(double v)     { return v; }
+double value(FP v)         { return v.toDouble(); }
+
+template <class T>
+double run_scalar(Columns<T>& c, const BasicConfig<T>& cfg, int steps, double& sink) {
+    const size_t n = c.cap.size();
+    const double t0 = now_s();
+    for (int k = 0; k < steps; ++k) {
+        for (size_t i = 0; i < n; ++i) {
+            BasicResult<T> r;
+            c.stored[i] = step(BasicState<T>{c.stored[i], c.cap[i]},
+                               BasicInputs<T>{c.prod[i], c.crit[i], c.noncrit[i], c.dt[i]}, cfg, r).storedWh;
+            c.eff[i]   = r.nonCriticalEff;
+            c.in[i]    = r.battInWh;
+            c.out[i]   = r.battOutWh;
+            c.unmet[i] = r.unmetCriticalWh;
+        }
+    }
+    const double t1 = now_s();
+    for (size_t i = 0; i < n; ++i) sink += value(c.stored[i]) + value(c.in[i]);
+    return (t1 - t0) * 1e9 / (double(steps) * double(n));
+}
+
+template <class T>
+double run_batch(Columns<T>& c, const BasicConfig<T>& cfg, int steps, double& sink) {
+    const size_t n = c.cap.size();
+    const double t0 = now_s();
+    for (int k = 0; k < steps; ++k) {
+        step_batch(n, BasicStateSoA<T>{c.stored.data(), c.cap.data()},
+                   BasicInputsSoA<T>{c.prod.data(), c.crit.data(), c.noncrit.data(), c.dt.data()}, cfg,
+                   BasicResultSoA<T>{c.eff.data(), c.in.data(), c.out.data(), c.unmet.data()});
+    }
+    const double t1 = now_s();
+    for (size_t i = 0; i < n; ++i) sink += value(c.stored[i]) + value(c.in[i]);
+    return (t1 - t0) * 1e9 / (double(steps) * double(n));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t n  = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+    const int steps = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+    const Config dcfg{0.92, 0.95, 0.5};
+    const FixedConfig fcfg{FP::fromDouble(0.92), FP::fromDouble(0.95), FP::fromDouble(0.5)};
+    double sink = 0.0;
+
+    Columns<double> d1(n, to_double), d2(n, to_double);
+    Columns<FP>     f1(n, to_fixed),  f2(n, to_fixed);
+    const double ds = run_scalar(d1, dcfg, steps, sink);
+    const double db = run_batch(d2, dcfg, steps, sink);
+    const double fs = run_scalar(f1, fcfg, steps, sink);
+    const double fb = run_batch(f2, fcfg, steps, sink);
+
+    std::printf("batteries=%zu steps=%d\n", n, steps);
+    std::printf("%-8s %12s %12s\n", "type", "scalar ns", "batch ns");
+    std::printf("%-8s %12.2f %12.2f\n", "double", ds, db);
+    std::printf("%-8s %12.2f %12.2f\n", "fixed", fs, fb);
+    std::printf("fixed/double: scalar %.2fx batch %.2fx  (sink %.3f)\n", fs / ds, fb / db, sink);
+    return 0;
+}
@@ -18,13 +18,16 @@ static int randInt(std::mt19937& rng, int lo, int hi) { // inclusive
 void startDustStorm(GameState& s, int hours, const StepOpts& opt) {
     if (s.weather.dustStorm) return;
     s.weather.dustStorm = true;
-    s.weather.dustStormHours = std::max(1, hours);
+    s.weather.dustStormEndHour = s.hour + std::max(1, hours);
     s.weather.solarMultiplier = 0.25; // strong attenuation
+    trackDustStorm(s);
     emit(opt, LogKind::Weather, "[Weather] A dust storm rolls in. Solar output reduced.");
 }
 
 void clearDustStorm(GameState& s, const StepOpts& opt) {
     if (!s.weather.dustStorm) return;
+    s.effects.cancel(s.weather.dustStormEffect); // no-op when it just expired
+    s.modifiers.remove(s.weather.dustStormModifier);
     s.weather = Weather{}; // reset to defaults
     emit(opt, LogKind::Weather, "[Weather] The dust storm has cleared.");
 }
@@ -1,4 +1,5 @@
 #include "persist.hpp"
+#include "../src/io/AsyncWriter.h"
 #include <fstream>
 #include <sstream>
 
@@ -16,10 +17,7 @@ static bool deserializeRng(std::mt19937& rng, const std::string& s) {
     return static_cast<bool>(iss);
 }
 
-bool saveGame(const GameState& s, const std::string& path) {
-    std::ofstream f(path);
-    if (!f) return false;
-
+static void writeSave(std::ostream& f, const GameState& s) {
     f << "hour=" << s.hour << "\n";
     f << "colonists=" << s.colonists << "\n";
     f << "solarPanels=" << s.solarPanels << "\n";
@@ -28,11 +26,27 @@ bool saveGame(const GameState& s, const std::string& path) {
     f << "powerStored=" << s.res.powerStored << "\n";
     f << "rng=" << serializeRng(s.rng) << "\n";
     f << "weather_dustStorm=" << (s.weather.dustStorm ? 1 : 0) << "\n";
-    f << "weather_dustStormHours=" << s.weather.dustStormHours << "\n";
+    f << "weather_dustStormEndHour=" << s.weather.dustStormEndHour << "\n";
     f << "weather_solarMultiplier=" << s.weather.solarMultiplier << "\n";
+}
+
+bool saveGame(const GameState& s, const std::string& path) {
+    std::ofstream f(path);
+    if (!f) return false;
+    writeSave(f, s);
     return true;
 }
 
+bool saveGame(const GameState& s, io::AsyncWriter& out, const std::string& path) {
+    std::ostringstream oss;
+    writeSave(oss, s);
+    const int fd = out.open(path);
+    if (fd < 0) return false;
+    const bool ok = out.append(fd, oss.str());
+    out.close_async(fd);
+    return ok;
+}
+
 bool loadGame(GameState& s, const std::string& path) {
     std::ifstream f(path);
     if (!f) return false;
@@ -40,6 +54,7 @@ bool loadGame(GameState& s, const std::string& path) {
     GameState tmp = s; // in case of partial read
     std::string line;
     std::string rngState;
+    int legacyStormHours = -1; // pre-end-hour saves stored hours remaining
 
     while (std::getline(f, line)) {
         auto pos = line.find('=');
@@ -55,7 +70,8 @@ bool loadGame(GameState& s, const std::string& path) {
         else if (key == "powerStored") tmp.res.powerStored = std::stod(val);
         else if (key == "rng") rngState = val;
         else if (key == "weather_dustStorm") tmp.weather.dustStorm = (std::stoi(val) != 0);
-        else if (key == "weather_dustStormHours") tmp.weather.dustStormHours = std::stoi(val);
+        else if (key == "weather_dustStormEndHour") tmp.weather.dustStormEndHour = std::stoi(val);
+        else if (key == "weather_dustStormHours") legacyStormHours = std::stoi(val);
         else if (key == "weather_solarMultiplier") tmp.weather.solarMultiplier = std::stod(val);
     }
 
@@ -65,6 +81,14 @@ bool loadGame(GameState& s, const std::string& path) {
         }
     }
 
+    // Effects and modifiers aren't serialized; rebuild them from the weather fields.
+    if (legacyStormHours >= 0) tmp.weather.dustStormEndHour = tmp.hour + legacyStormHours;
+    tmp.effects.clear();
+    tmp.modifiers.clear();
+    tmp.weather.dustStormEffect = effects::kNoEffect;
+    tmp.weather.dustStormModifier = effects::kNoModifier;
+    if (tmp.weather.dustStorm) trackDustStorm(tmp);
+
     recomputePowerCapacity(tmp);
     // Clamp stored energy to capacity
     if (tmp.res.powerStored > tmp.res.powerCapKWh) tmp.res.powerStored = tmp.res.powerCapKWh;
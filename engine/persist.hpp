@@ -4,7 +4,12 @@
 
 namespace mars {
 
+namespace io { class AsyncWriter; }
+
 bool saveGame(const GameState& s, const std::string& path);
+// Checkpoint through the async writer; queued writes complete in the
+// background until the writer is drained or the file closed.
+bool saveGame(const GameState& s, io::AsyncWriter& out, const std::string& path);
 bool loadGame(GameState& s, const std::string& path);
 
 } // namespace mars
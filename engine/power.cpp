@@ -1,16 +1,19 @@
 #include "power.hpp"
-#include <algorithm>
-#include <cmath>
+#include "../fixed_math.h"
 
 namespace mars {
 
 // Cosine-smoothed daylight curve: 0 at night, 1 at local noon
 double daylightFactor(int hourOfSol) {
-    // Map hour (0..23) onto [0, 2π), shift so noon peaks at 1.0
-    double theta = (static_cast<double>(hourOfSol) / SOL_HOURS) * 2.0 * PI;
-    double c = std::cos(theta - PI); // =1 at noon (hour 12)
-    if (c < 0.0) c = 0.0;
-    return c; // 0..1 (soft twilight shoulders)
+    // Map hour (0..23) onto [-π, π) around noon. Fixed-point cos, so the
+    // curve doesn't depend on the platform's libm; Q32 keeps it within 1e-8
+    // of the exact cosine.
+    using Q32 = FixedPoint<int64_t, 32>;
+    const int half = SOL_HOURS / 2;
+    const Q32 theta = Q32::div<Round::NearestEven>(fixed_pi<Q32>() * (hourOfSol - half), Q32::fromInt(half));
+    Q32 c = fixed_cos(theta); // =1 at noon (hour 12)
+    if (c < Q32{0}) c = Q32{0};
+    return c.toDouble(); // 0..1 (soft twilight shoulders)
 }
 
 } // namespace mars
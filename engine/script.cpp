@@ -0,0 +1,219 @@
+#include "script.hpp"
+#include "events.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace mars {
+
+// ---------- Timeline builder ----------
+
+Timeline& Timeline::wait_battery_below(double frac) {
+    ScriptInstr in{ScriptOp::WaitBatteryBelow};
+    in.value = frac;
+    return push(in);
+}
+
+Timeline& Timeline::if_battery_below(double frac) {
+    ScriptInstr in{ScriptOp::IfBatteryBelow};
+    in.value = frac;
+    openIfs_.push_back(static_cast<int>(prog_.code.size()));
+    return push(in);
+}
+
+Timeline& Timeline::end_if() {
+    assert(!openIfs_.empty() && "Timeline::end_if without if_battery_below");
+    if (openIfs_.empty()) return *this;
+    prog_.code[static_cast<size_t>(openIfs_.back())].jump = static_cast<int>(prog_.code.size());
+    openIfs_.pop_back();
+    return *this;
+}
+
+Timeline& Timeline::log(std::string text) {
+    prog_.text.push_back(std::move(text));
+    return push({ScriptOp::Log, static_cast<int>(prog_.text.size() - 1)});
+}
+
+Program Timeline::build() {
+    while (!openIfs_.empty()) end_if(); // tolerate a missing trailing end_if
+    push({ScriptOp::End});
+    Program out = std::move(prog_);
+    prog_ = Program{};
+    return out;
+}
+
+// ---------- Runner ----------
+
+// Min-heap order on (due, seq): equal hours keep their park order.
+bool ScriptRunner::farLater(const FarEntry& a, const FarEntry& b) {
+    return a.due != b.due ? a.due > b.due : a.seq > b.seq;
+}
+
+// Max-heap on the threshold: the wait nearest to waking is on top, and
+// equal thresholds wake in park order.
+bool ScriptRunner::batteryLater(const BatteryWait& a, const BatteryWait& b) {
+    return a.below != b.below ? a.below < b.below : a.seq > b.seq;
+}
+
+static double stateOfCharge(const GameState& s) {
+    const double cap = s.res.powerCapKWh;
+    return (cap > 0.0) ? s.res.powerStored / cap : 0.0;
+}
+
+ScriptRunner::ScriptRunner() : wheel_(kWheelSlots) {}
+
+ScriptRunner::ProgramId ScriptRunner::addProgram(Program p) {
+    programs_.push_back(std::move(p));
+    return static_cast<ProgramId>(programs_.size() - 1);
+}
+
+ScriptRunner::TaskId ScriptRunner::spawn(ProgramId prog, int hour) {
+    TaskId id;
+    if (!freeTasks_.empty()) {
+        id = freeTasks_.back();
+        freeTasks_.pop_back();
+    } else {
+        id = static_cast<TaskId>(tasks_.size());
+        tasks_.emplace_back();
+    }
+    tasks_[id] = Task{prog, 0, true};
+    park(id, std::max(hour, now_));
+    return id;
+}
+
+void ScriptRunner::park(TaskId id, int due) {
+    if (due - now_ < kWheelSlots) {
+        wheel_[static_cast<size_t>(due) & (kWheelSlots - 1)].push_back(id);
+        return;
+    }
+    far_.push_back(FarEntry{due, farSeq_++, id});
+    std::push_heap(far_.begin(), far_.end(), farLater);
+}
+
+void ScriptRunner::parkBattery(TaskId id, double below) {
+    battery_.push_back(BatteryWait{below, farSeq_++, id});
+    std::push_heap(battery_.begin(), battery_.end(), batteryLater);
+}
+
+void ScriptRunner::wakeBattery(GameState& s, const StepOpts& opt) {
+    // A woken task may change the charge, so it's re-read for every wait.
+    while (!battery_.empty() && stateOfCharge(s) < battery_.front().below) {
+        std::pop_heap(battery_.begin(), battery_.end(), batteryLater);
+        const TaskId id = battery_.back().task;
+        battery_.pop_back();
+        resume(id, s, opt);
+    }
+}
+
+void ScriptRunner::migrateFar() {
+    while (!far_.empty() && far_.front().due - now_ < kWheelSlots) {
+        std::pop_heap(far_.begin(), far_.end(), farLater);
+        const FarEntry e = far_.back();
+        far_.pop_back();
+        wheel_[static_cast<size_t>(e.due) & (kWheelSlots - 1)].push_back(e.task);
+    }
+}
+
+void ScriptRunner::finish(TaskId id) {
+    tasks_[id].live = false;
+    freeTasks_.push_back(id);
+}
+
+void ScriptRunner::runHour(GameState& s, const StepOpts& opt) {
+    // Catch up on any hours we were not called for; each is O(due tasks).
+    while (now_ <= s.hour) {
+        wakeBattery(s, opt);
+        migrateFar();
+        auto& slot = wheel_[static_cast<size_t>(now_) & (kWheelSlots - 1)];
+        // Parks from resume() always land in a different slot, so indexing
+        // stays valid while we iterate.
+        for (size_t i = 0; i < slot.size(); ++i) {
+            resume(slot[i], s, opt);
+        }
+        slot.clear();
+        ++now_;
+    }
+}
+
+void ScriptRunner::rebase(int hour) {
+    // Wheel entries are due in [now_, now_ + kWheelSlots), so each slot
+    // names one hour; far entries carry theirs.
+    std::vector<FarEntry> due;
+    for (int h = now_; h < now_ + kWheelSlots; ++h) {
+        auto& slot = wheel_[static_cast<size_t>(h) & (kWheelSlots - 1)];
+        for (TaskId id : slot) due.push_back(FarEntry{h, 0, id});
+        slot.clear();
+    }
+    std::sort(far_.begin(), far_.end(), [](const FarEntry& a, const FarEntry& b) { return farLater(b, a); });
+    due.insert(due.end(), far_.begin(), far_.end());
+    far_.clear();
+    const int shift = hour - now_;
+    now_ = hour;
+    for (const FarEntry& e : due) park(e.task, e.due + shift);
+}
+
+void ScriptRunner::resume(TaskId id, GameState& s, const StepOpts& opt) {
+    Task& t = tasks_[id];
+    if (!t.live) return;
+    const Program& prog = programs_[t.prog];
+    const int hour = now_;
+
+    for (int budget = 0; budget < kMaxInstrPerResume; ++budget) {
+        if (t.pc < 0 || static_cast<size_t>(t.pc) >= prog.code.size()) {
+            finish(id);
+            return;
+        }
+        const ScriptInstr& in = prog.code[static_cast<size_t>(t.pc)];
+        const double soc = stateOfCharge(s);
+
+        switch (in.op) {
+            case ScriptOp::WaitUntilHour:
+                ++t.pc;
+                if (in.arg > hour) { park(id, in.arg); return; }
+                break;
+            case ScriptOp::WaitHours:
+                ++t.pc;
+                if (in.arg > 0) { park(id, hour + in.arg); return; }
+                break;
+            case ScriptOp::WaitBatteryBelow:
+                ++t.pc;
+                if (soc < in.value) break;
+                parkBattery(id, in.value);
+                return;
+            case ScriptOp::IfBatteryBelow:
+                t.pc = (soc < in.value) ? t.pc + 1 : in.jump;
+                break;
+            case ScriptOp::Jump:
+                t.pc = in.jump;
+                break;
+            case ScriptOp::StartDustStorm:
+                startDustStorm(s, in.arg, opt);
+                ++t.pc;
+                break;
+            case ScriptOp::ClearDustStorm:
+                clearDustStorm(s, opt);
+                ++t.pc;
+                break;
+            case ScriptOp::SupplyDrop:
+                supplyDrop(s, opt);
+                ++t.pc;
+                break;
+            case ScriptOp::MeteoroidStrike:
+                meteoroidStrike(s, opt);
+                ++t.pc;
+                break;
+            case ScriptOp::Log:
+                if (in.arg >= 0 && static_cast<size_t>(in.arg) < prog.text.size()) {
+                    emit(opt, LogKind::Event, prog.text[static_cast<size_t>(in.arg)]);
+                }
+                ++t.pc;
+                break;
+            case ScriptOp::End:
+                finish(id);
+                return;
+        }
+    }
+    // Ran out of budget without waiting: yield until next hour.
+    park(id, hour + 1);
+}
+
+} // namespace mars
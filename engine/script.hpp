@@ -0,0 +1,148 @@
+#pragma once
+#include "state.hpp"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace mars {
+
+// ---------- Scenario scripting ----------
+//
+// Scripts are tiny hand-rolled state machines: a Program is a flat list of
+// instructions and a running task is just (program, pc). A task runs until it
+// hits a wait, then parks in a timing wheel keyed by absolute sim hour, so a
+// sleeping script costs nothing until the hour it can make progress again.
+// Battery waits park in a heap ordered by threshold instead: each hour only
+// the highest threshold is compared with the state of charge.
+//
+//   Program p = Timeline()
+//       .at_sol(30)
+//       .if_battery_below(0.20)
+//           .start_dust_storm(24)
+//           .wait_sols(3)
+//           .supply_drop()
+//       .end_if()
+//       .build();
+
+enum class ScriptOp : uint8_t {
+    WaitUntilHour,     // park until absolute hour `arg`
+    WaitHours,         // park for `arg` hours
+    WaitBatteryBelow,  // park until state of charge < `value`
+    IfBatteryBelow,    // fall through if SoC < `value`, else jump to `jump`
+    Jump,              // unconditional jump to `jump`
+    StartDustStorm,    // `arg` hours
+    ClearDustStorm,
+    SupplyDrop,
+    MeteoroidStrike,
+    Log,               // emit Program::text[arg]
+    End
+};
+
+struct ScriptInstr {
+    ScriptOp op    = ScriptOp::End;
+    int      arg   = 0;
+    double   value = 0.0;
+    int      jump  = -1;
+};
+
+struct Program {
+    std::vector<ScriptInstr> code;
+    std::vector<std::string> text; // string table for ScriptOp::Log
+};
+
+// Fluent builder; patches the jump targets of if/end_if blocks.
+class Timeline {
+public:
+    Timeline& at_hour(int hour)     { return push({ScriptOp::WaitUntilHour, hour}); }
+    Timeline& at_sol(int sol)       { return at_hour(sol * SOL_HOURS); }
+    Timeline& wait_hours(int hours) { return push({ScriptOp::WaitHours, hours}); }
+    Timeline& wait_sols(int sols)   { return wait_hours(sols * SOL_HOURS); }
+    Timeline& wait_battery_below(double frac);
+    Timeline& if_battery_below(double frac);
+    Timeline& end_if();
+    Timeline& start_dust_storm(int hours) { return push({ScriptOp::StartDustStorm, hours}); }
+    Timeline& clear_dust_storm()   { return push({ScriptOp::ClearDustStorm}); }
+    Timeline& supply_drop()        { return push({ScriptOp::SupplyDrop}); }
+    Timeline& meteoroid_strike()   { return push({ScriptOp::MeteoroidStrike}); }
+    Timeline& log(std::string text);
+
+    Program build();
+
+private:
+    Timeline& push(ScriptInstr in) { prog_.code.push_back(in); return *this; }
+
+    Program          prog_;
+    std::vector<int> openIfs_;
+};
+
+// Owns programs and running tasks. Call runHour() once per sim hour, before
+// simulateHour(), with the same GameState the hour is about to simulate;
+// stepHour() (step.hpp) does both.
+class ScriptRunner {
+public:
+    using ProgramId = uint32_t;
+    using TaskId    = uint32_t;
+
+    // Slots in the near wheel (hours). Waits further out sit in an overflow
+    // heap and are moved into the wheel once they come within range.
+    static constexpr int kWheelSlots = 256;
+    // Upper bound on instructions per resume, so a wait-less loop can't hang
+    // the hour; the task is parked for one hour when it trips.
+    static constexpr int kMaxInstrPerResume = 1024;
+
+    ScriptRunner();
+
+    ProgramId addProgram(Program p);
+    // Starts a task at `hour` (clamped to the next hour the runner will run).
+    TaskId    spawn(ProgramId prog, int hour);
+
+    void runHour(GameState& s, const StepOpts& opt);
+
+    // Moves the clock to `hour`, e.g. after loading a save, keeping each
+    // timed wait's remaining hours. The next runHour() runs `hour`.
+    void rebase(int hour);
+
+    size_t activeTasks() const { return tasks_.size() - freeTasks_.size(); }
+    int    nextHour() const    { return now_; }
+
+private:
+    struct Task {
+        ProgramId prog = 0;
+        int       pc   = 0;
+        bool      live = false;
+    };
+    struct FarEntry {
+        int      due;
+        uint64_t seq;
+        TaskId   task;
+    };
+    struct BatteryWait {
+        double   below;
+        uint64_t seq;
+        TaskId   task;
+    };
+
+    static bool farLater(const FarEntry& a, const FarEntry& b);
+    static bool batteryLater(const BatteryWait& a, const BatteryWait& b);
+
+    void park(TaskId id, int due);
+    void parkBattery(TaskId id, double below);
+    // Resumes battery waits whose threshold the state of charge is under.
+    void wakeBattery(GameState& s, const StepOpts& opt);
+    void migrateFar();
+    // Runs one task until it parks or ends.
+    void resume(TaskId id, GameState& s, const StepOpts& opt);
+    void finish(TaskId id);
+
+    std::deque<Program>                 programs_; // stable addresses
+    std::vector<Task>                   tasks_;
+    std::vector<TaskId>                 freeTasks_;
+    std::vector<std::vector<TaskId>>    wheel_;
+    std::vector<FarEntry>               far_;      // min-heap on (due, seq)
+    std::vector<BatteryWait>            battery_;  // max-heap on below, then min seq
+    uint64_t                            farSeq_ = 0;
+    int                                 now_    = 0;
+};
+
+} // namespace mars
@@ -1,10 +1,14 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <functional>
 #include <random>
 #include <vector>
 #include <iostream>
+#include "../src/effects.hpp"
+#include "../src/modifiers.hpp"
 
 namespace mars {
 
@@ -18,13 +22,17 @@ constexpr double BATTERY_MAX_RATE_KW     = 10.0; // per battery (charge or disch
 constexpr double LIFE_SUPPORT_BASE_KW    = 1.5;
 constexpr double CRIT_PER_COLONIST_KW    = 0.25;
 constexpr double LAB_KW                  = 1.2;
+constexpr size_t MAX_TIMED_EFFECTS       = 8;    // GameState::effects capacity
+constexpr size_t MAX_STAT_MODIFIERS      = 16;   // GameState::modifiers capacity
 
 // ---------- Typed log / message bus ----------
 enum class LogKind { Info, Warning, Event, Weather };
 
+// `text` is only valid for the duration of the sink call; sinks that keep
+// messages must copy them. This keeps emit() allocation-free on the hot path.
 struct LogMsg {
-    LogKind     kind;
-    std::string text;
+    LogKind          kind;
+    std::string_view text;
 };
 
 using LogSink = std::function<void(const LogMsg&)>;
@@ -41,8 +49,8 @@ struct StepOpts {
 };
 
 // Helper to emit messages safely
-inline void emit(const StepOpts& opt, LogKind k, std::string text) {
-    if (opt.sink) opt.sink(LogMsg{k, std::move(text)});
+inline void emit(const StepOpts& opt, LogKind k, std::string_view text) {
+    if (opt.sink) opt.sink(LogMsg{k, text});
 }
 
 // ---------- State aggregates ----------
@@ -61,8 +69,24 @@ struct PowerSnapshot {
 
 struct Weather {
     bool   dustStorm        = false;
-    int    dustStormHours   = 0;    // remaining
-    double solarMultiplier  = 1.0;  // < 1 during storms
+    int    dustStormEndHour = 0;    // absolute hour the storm clears
+    double solarMultiplier  = 1.0;  // storm's factor on Stat::SolarOutput
+    effects::EffectId   dustStormEffect   = effects::kNoEffect;
+    effects::ModifierId dustStormModifier = effects::kNoModifier;
+
+    int dustStormHoursLeft(int now) const {
+        return dustStorm ? std::max(0, dustStormEndHour - now) : 0;
+    }
+};
+
+// Tags for GameState::effects entries.
+enum class EffectKind { DustStorm };
+
+// Stats that effects can modify; read through GameState::modifiers.
+enum class Stat : uint8_t {
+    SolarOutput,   // kW from panels
+    CriticalLoad,  // kW of life support
+    COUNT
 };
 
 struct GameState {
@@ -79,6 +103,8 @@ struct GameState {
     Resources     res;
     PowerSnapshot lastPower;
     Weather       weather;
+    effects::EffectStore<MAX_TIMED_EFFECTS> effects; // by absolute expiry hour
+    effects::StatModifiers<Stat, MAX_STAT_MODIFIERS> modifiers;
 
     // RNG
     std::mt19937  rng;
@@ -96,6 +122,16 @@ inline void recomputePowerCapacity(GameState& s) {
     }
 }
 
+// Registers the active storm's end hour and solar penalty. Either store can
+// be full; the storm then runs off its Weather fields instead: tickEffects()
+// ends it at dustStormEndHour and simulateHour() applies solarMultiplier.
+inline void trackDustStorm(GameState& s) {
+    s.weather.dustStormEffect = s.effects.add(effects::Effect{
+        s.weather.dustStormEndHour, static_cast<int>(EffectKind::DustStorm), "The dust storm"});
+    s.weather.dustStormModifier =
+        s.modifiers.add(Stat::SolarOutput, effects::ModOp::Mul, s.weather.solarMultiplier);
+}
+
 inline void initDefaultGame(GameState& s, uint32_t seed = 42u) {
     s.hour        = 0;
     s.colonists   = 6;
@@ -104,6 +140,8 @@ inline void initDefaultGame(GameState& s, uint32_t seed = 42u) {
     s.labs        = 1;
 
     s.weather = Weather{};
+    s.effects.clear();
+    s.modifiers.clear();
     s.rng.seed(seed);
 
     recomputePowerCapacity(s);
@@ -1,6 +1,8 @@
 #include "step.hpp"
 #include "power.hpp"
 #include "events.hpp"
+#include "script.hpp"
+#include "../include/mars/latency.hpp"
 #include <algorithm>
 #include <cmath>
 
@@ -11,16 +13,22 @@ static double clamp(double x, double lo, double hi) {
 }
 
 void simulateHour(GameState& s, const StepOpts& opt) {
+    static LatencyMetric& lat = latency_metric("engine.simulate_hour");
+    ScopedLatency timed(lat);
+
     // 1) Random events (if any)
     maybeSpawnRandomEvent(s, opt);
 
     // 2) Power production (kW) for this hour
     double day = daylightFactor(s.hourOfSol());
-    double solarKW = s.solarPanels * SOLAR_PANEL_KW * day *
-                     (s.weather.dustStorm ? s.weather.solarMultiplier : 1.0);
+    double solarKW = s.modifiers.apply(Stat::SolarOutput, s.solarPanels * SOLAR_PANEL_KW * day);
+    if (s.weather.dustStorm && s.weather.dustStormModifier == effects::kNoModifier) {
+        solarKW *= s.weather.solarMultiplier; // modifier set was full (trackDustStorm)
+    }
 
     // 3) Demands (kW)
-    double criticalKW = LIFE_SUPPORT_BASE_KW + s.colonists * CRIT_PER_COLONIST_KW;
+    double criticalKW = s.modifiers.apply(Stat::CriticalLoad,
+                                          LIFE_SUPPORT_BASE_KW + s.colonists * CRIT_PER_COLONIST_KW);
     double noncritKW  = s.labs * LAB_KW;
 
     // 4) Discharge to cover critical only
@@ -70,18 +78,30 @@ void simulateHour(GameState& s, const StepOpts& opt) {
 }
 
 void tickEffects(GameState& s, const StepOpts& opt) {
-    // Decrement any active effect durations (dust storm)
-    if (s.weather.dustStorm) {
-        s.weather.dustStormHours -= 1;
-        if (s.weather.dustStormHours <= 0) {
-            clearDustStorm(s, opt);
+    // Only effects whose absolute expiry has been reached are touched.
+    s.effects.expire(s.hour, [&](const effects::Effect& e) {
+        switch (static_cast<EffectKind>(e.kind)) {
+            case EffectKind::DustStorm: clearDustStorm(s, opt); break;
         }
+    });
+    // A storm that didn't fit in the effect store ends by its own field.
+    if (s.weather.dustStorm && s.weather.dustStormEffect == effects::kNoEffect &&
+        s.hour >= s.weather.dustStormEndHour) {
+        clearDustStorm(s, opt);
     }
 }
 
-Forecast runForecast(GameState& s, int hours) {
+void stepHour(GameState& s, const StepOpts& opt, ScriptRunner* scripts) {
+    if (scripts) scripts->runHour(s, opt);
+    simulateHour(s, opt);
+    tickEffects(s, opt);
+}
+
+Forecast runForecast(GameState& s, int hours, std::pmr::memory_resource* mr) {
+    static LatencyMetric& lat = latency_metric("engine.forecast");
+    ScopedLatency timed(lat);
     hours = std::max(0, hours);
-    Forecast out;
+    Forecast out(mr);
     out.solIndex.reserve(hours);
     out.hourOfSol.reserve(hours);
     out.producers.reserve(hours);
@@ -1,24 +1,37 @@
 #pragma once
 #include "state.hpp"
+#include <memory_resource>
 #include <vector>
 
 namespace mars {
 
+class ScriptRunner;
+
+// Series live in `mr`; pass a FrameArena to keep forecasts off the global heap
+// and reset it once the forecast has been consumed.
 struct Forecast {
-    std::vector<int>    solIndex;     // sol number at each step
-    std::vector<int>    hourOfSol;    // hour in sol
-    std::vector<double> producers;    // kW
-    std::vector<double> critical;     // kW
-    std::vector<double> noncrit;      // kW potential
-    std::vector<double> noncritEff;   // 0..1 actually served
-    std::vector<double> battery;      // kWh
-    std::vector<uint8_t> blackout;    // 0/1
+    explicit Forecast(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : solIndex(mr), hourOfSol(mr), producers(mr), critical(mr),
+          noncrit(mr), noncritEff(mr), battery(mr), blackout(mr) {}
+
+    std::pmr::vector<int>    solIndex;     // sol number at each step
+    std::pmr::vector<int>    hourOfSol;    // hour in sol
+    std::pmr::vector<double> producers;    // kW
+    std::pmr::vector<double> critical;     // kW
+    std::pmr::vector<double> noncrit;      // kW potential
+    std::pmr::vector<double> noncritEff;   // 0..1 actually served
+    std::pmr::vector<double> battery;      // kWh
+    std::pmr::vector<uint8_t> blackout;    // 0/1
 };
 
 void simulateHour(GameState& s, const StepOpts& opt);
 void tickEffects(GameState& s, const StepOpts& opt);
 
+// One interactive hour: due scripts, then simulateHour and tickEffects.
+void stepHour(GameState& s, const StepOpts& opt, ScriptRunner* scripts = nullptr);
+
 // Run N silent hours with no random events; return series and restore state
-Forecast runForecast(GameState& s, int hours);
+Forecast runForecast(GameState& s, int hours,
+                     std::pmr::memory_resource* mr = std::pmr::get_default_resource());
 
 } // namespace mars
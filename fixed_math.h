@@ -0,0 +1,251 @@
+// fixed_math.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include "fixed_point.h"
+
+// Transcendentals over FixedPoint whose results are fixed by integer
+// arithmetic, so every platform and compiler produces the same bits (libm
+// does not: glibc and MSVC disagree in the last place). Internally they run
+// in Q30 in int64, well below the 2^-16 of FP, and round to the result type
+// once at the end (nearest, ties to even). Error bounds below are absolute
+// unless stated and come on top of that final half-ulp rounding.
+//
+//   fixed_sin/cos(x)   x in radians, any range     |err| <= 5e-9
+//   fixed_exp(x)       saturates above the range   rel. err <= 6e-9
+//   fixed_sqrt(x)      x < 0 gives 0               correctly rounded
+//   fixed_atan2(y, x)  result in [-pi, pi]         |err| <= 2e-8 rad
+//
+// sin/cos/exp are a table lookup plus a short polynomial, atan2 is a short
+// CORDIC plus a series, and sqrt is a double estimate corrected in integers.
+// The (n, in..., out) batch forms are plain loops with no cross-lane
+// dependencies; the table gathers and 64-bit multiplies keep them scalar on
+// SSE2/AVX2.
+
+namespace fixed_math_detail {
+
+constexpr int     kQ   = 30;
+constexpr int64_t kOne = int64_t{1} << kQ;
+
+constexpr int64_t kPiQ61     = 7244019458077122842;   // pi * 2^61
+constexpr int64_t kInv2PiQ62 = 733972625820500307;    // 1/(2 pi) * 2^62
+constexpr int64_t kLog2eQ62  = 6653256548922161246;   // log2(e) * 2^62
+constexpr int64_t kLn2Q30    = 744261118;
+constexpr int64_t kHalfPiQ30 = 1686629713;
+constexpr int64_t kPiQ30     = 3373259426;
+
+// sin(k pi / 128), k = 0..64, Q30. cos of the same angle is entry 64 - k.
+constexpr int32_t kSin[65] = {
+  0, 26350943, 52686014, 78989349, 105245103, 131437462, 157550647, 183568930,
+  209476638, 235258165, 260897982, 286380643, 311690799, 336813204, 361732726, 386434353,
+  410903207, 435124548, 459083786, 482766489, 506158392, 529245404, 552013618, 574449320,
+  596538995, 618269338, 639627258, 660599890, 681174602, 701339000, 721080937, 740388522,
+  759250125, 777654384, 795590213, 813046808, 830013654, 846480531, 862437520, 877875009,
+  892783698, 907154608, 920979082, 934248793, 946955747, 959092290, 970651112, 981625251,
+  992008094, 1001793390, 1010975242, 1019548121, 1027506862, 1034846671, 1041563127, 1047652185,
+  1053110176, 1057933813, 1062120190, 1065666786, 1068571464, 1070832474, 1072448455, 1073418433,
+  1073741824,
+};
+
+// 2^(k/64), k = 0..63, Q30.
+constexpr int64_t kExp2[64] = {
+  1073741824, 1085434106, 1097253708, 1109202018, 1121280436, 1133490379, 1145833280, 1158310587,
+  1170923762, 1183674286, 1196563654, 1209593378, 1222764986, 1236080024, 1249540052, 1263146652,
+  1276901417, 1290805962, 1304861917, 1319070932, 1333434672, 1347954824, 1362633090, 1377471191,
+  1392470869, 1407633882, 1422962010, 1438457051, 1454120821, 1469955159, 1485961921, 1502142985,
+  1518500250, 1535035634, 1551751076, 1568648537, 1585730000, 1602997467, 1620452965, 1638098541,
+  1655936265, 1673968228, 1692196547, 1710623359, 1729250827, 1748081133, 1767116489, 1786359126,
+  1805811301, 1825475297, 1845353420, 1865448001, 1885761398, 1906295993, 1927054196, 1948038440,
+  1969251188, 1990694927, 2012372174, 2034285470, 2056437387, 2078830522, 2101467502, 2124350982,
+};
+
+// atan(2^-i), i = 0..7, Q30 radians.
+constexpr int32_t kAtan[8] = {
+  843314857, 497837829, 263043837, 133525159, 67021687, 33543516, 16775851, 8388437,
+};
+
+// Both operands within a few units of kOne, so the product fits.
+constexpr int64_t qmul(int64_t a, int64_t b) { return (a * b) >> kQ; }
+
+// v / 2^s, nearest with ties to even; 0 <= s < 63.
+constexpr int64_t round_shift(int64_t v, int s) {
+  if (s == 0) return v;
+  const int64_t q    = v >> s;
+  const int64_t rem  = v & ((int64_t{1} << s) - 1);
+  const int64_t half = int64_t{1} << (s - 1);
+  return (rem > half || (rem == half && (q & 1) != 0)) ? q + 1 : q;
+}
+
+// A Q`q` value as Fx, saturating.
+template <class Fx>
+constexpr Fx from_q(int64_t v, int q) {
+  constexpr int F = Fx::kFracBits;
+  int64_t r = 0;
+  if (q >= F) {
+    r = round_shift(v, q - F);
+  } else if (F - q >= 63) {
+    r = v > 0 ? INT64_MAX : v < 0 ? INT64_MIN : 0;
+  } else {
+    const int s = F - q;
+    if (v > (INT64_MAX >> s)) r = INT64_MAX;
+    else if (v < (INT64_MIN >> s)) r = INT64_MIN;
+    else r = v * (int64_t{1} << s);
+  }
+  if (r > static_cast<int64_t>(Fx::kMax)) return Fx::max();
+  if (r < static_cast<int64_t>(Fx::kMin)) return Fx::lowest();
+  return Fx{static_cast<typename Fx::rep>(r)};
+}
+
+// Angle in radians as a Q32 fraction of a turn, wrapped into [0, 1).
+template <class Fx>
+constexpr uint32_t to_turn(Fx x) {
+  using W = fixed_detail::int128;
+  const W p = W(static_cast<int64_t>(x.raw)) * W(kInv2PiQ62);        // Q(F + 62) turns
+  return static_cast<uint32_t>(static_cast<uint64_t>(static_cast<int64_t>(p >> (Fx::kFracBits + 30))));
+}
+
+// sin and cos of a Q32 turn, Q30.
+constexpr void sincos_turn(uint32_t t, int64_t& s, int64_t& c) {
+  const uint32_t quadrant = t >> 30;
+  const uint32_t u        = t & ((1u << 30) - 1);           // Q30 of a quarter turn
+  const int      k        = static_cast<int>(u >> 24);      // 64 segments per quadrant
+  const int64_t  h        = (static_cast<int64_t>(u & ((1u << 24) - 1)) * kHalfPiQ30) >> kQ;  // < pi/128
+
+  const int64_t h2   = qmul(h, h);
+  const int64_t sh = h - qmul(h, h2) / 6;                   // h^5/120 < 1e-10
+  const int64_t ch = kOne - h2 / 2 + qmul(h2, h2) / 24;
+  const int64_t sa = kSin[k], ca = kSin[64 - k];
+  const int64_t s0 = qmul(sa, ch) + qmul(ca, sh);
+  const int64_t c0 = qmul(ca, ch) - qmul(sa, sh);
+
+  switch (quadrant) {
+    case 0:  s =  s0; c =  c0; break;
+    case 1:  s =  c0; c = -s0; break;
+    case 2:  s = -s0; c = -c0; break;
+    default: s = -c0; c =  s0; break;
+  }
+}
+
+// Number of significant bits of v (0 for 0).
+constexpr int bit_width(uint64_t v) {
+  int n = 0;
+  for (int step = 32; step > 0; step >>= 1) {
+    if (v >> step) { v >>= step; n += step; }
+  }
+  return n + static_cast<int>(v);
+}
+
+} // namespace fixed_math_detail
+
+template <class Fx>
+constexpr Fx fixed_pi() { return fixed_math_detail::from_q<Fx>(fixed_math_detail::kPiQ61, 61); }
+
+template <class Fx>
+constexpr Fx fixed_sin(Fx x) {
+  int64_t s = 0, c = 0;
+  fixed_math_detail::sincos_turn(fixed_math_detail::to_turn(x), s, c);
+  return fixed_math_detail::from_q<Fx>(s, fixed_math_detail::kQ);
+}
+
+template <class Fx>
+constexpr Fx fixed_cos(Fx x) {
+  int64_t s = 0, c = 0;
+  fixed_math_detail::sincos_turn(fixed_math_detail::to_turn(x), s, c);
+  return fixed_math_detail::from_q<Fx>(c, fixed_math_detail::kQ);
+}
+
+// e^x = 2^n * 2^(k/64) * 2^r with r < 1/64, the last by a quartic in r ln 2.
+template <class Fx>
+constexpr Fx fixed_exp(Fx x) {
+  namespace d = fixed_math_detail;
+  using W = fixed_detail::int128;
+  constexpr int F = Fx::kFracBits;
+
+  const W y = (W(static_cast<int64_t>(x.raw)) * W(d::kLog2eQ62)) >> (F + 32);   // Q30 of log2(e^x)
+  const W n128 = y >> d::kQ;
+  if (n128 > W(64)) return Fx::max();
+  if (n128 < W(-64)) return Fx{0};
+  const int     n = static_cast<int>(static_cast<int64_t>(n128));
+  const int64_t f = static_cast<int64_t>(y - n128 * W(d::kOne));           // [0, 1) in Q30
+
+  const int64_t u  = ((f & ((int64_t{1} << 24) - 1)) * d::kLn2Q30) >> d::kQ;  // r ln 2 < 0.011
+  const int64_t u2 = d::qmul(u, u);
+  const int64_t p  = d::kOne + u + u2 / 2 + d::qmul(u2, u) / 6 + d::qmul(u2, u2) / 24;
+  const int64_t m  = d::qmul(d::kExp2[f >> 24], p);                          // [1, 2) in Q30
+
+  // m * 2^n in Q30 is m in Q(30 - n).
+  const int q = d::kQ - n;
+  if (q - F >= 63) return Fx{0};
+  return d::from_q<Fx>(m, q);
+}
+
+// Hardware sqrt of the radicand as a double gives a root within one of the
+// true one; integer squaring then corrects it, so the result is exact and
+// does not depend on how the platform rounds the estimate.
+template <class Fx>
+inline Fx fixed_sqrt(Fx x) {
+  static_assert(std::numeric_limits<typename Fx::rep>::digits + Fx::kFracBits <= 120,
+                "fixed_sqrt: the root must fit in 60 bits");
+  using W = fixed_detail::int128;
+  if (x.raw <= 0) return Fx{0};
+  const W n = W(static_cast<int64_t>(x.raw)) * W(int64_t{1} << Fx::kFracBits);
+  int64_t r = static_cast<int64_t>(std::sqrt(std::ldexp(static_cast<double>(x.raw), Fx::kFracBits)));
+  while (W(r) * W(r) > n) --r;
+  while (W(r + 1) * W(r + 1) <= n) ++r;
+  // (r + 1/2)^2 = r^2 + r + 1/4 is never an integer: no ties.
+  if (n - W(r) * W(r) > W(r)) ++r;
+  return Fx{static_cast<typename Fx::rep>(r)};
+}
+
+// CORDIC vectoring: rotate (x, y) towards the positive x axis by
+// +-atan(2^-i), summing the angles, then finish with a short series in y/x.
+// Inputs are first scaled to ~2^40 so the shifts keep precision whatever
+// their magnitude.
+template <class Fx>
+constexpr Fx fixed_atan2(Fx y, Fx x) {
+  namespace d = fixed_math_detail;
+  int64_t xv = static_cast<int64_t>(x.raw), yv = static_cast<int64_t>(y.raw);
+  if (xv == 0 && yv == 0) return Fx{0};
+
+  const uint64_t ax = xv < 0 ? 0 - static_cast<uint64_t>(xv) : static_cast<uint64_t>(xv);
+  const uint64_t ay = yv < 0 ? 0 - static_cast<uint64_t>(yv) : static_cast<uint64_t>(yv);
+  const int shift = d::bit_width(ax > ay ? ax : ay) - 41;   // top bit to 2^40
+  if (shift > 0) { xv >>= shift; yv >>= shift; }
+  else           { xv *= int64_t{1} << -shift; yv *= int64_t{1} << -shift; }
+
+  int64_t z = 0;
+  if (xv < 0) {                       // left half-plane: turn by pi first
+    z  = yv >= 0 ? d::kPiQ30 : -d::kPiQ30;
+    xv = -xv; yv = -yv;
+  }
+  for (int i = 0; i < 8; ++i) {
+    // The direction is a coin toss per step; multiply instead of branching.
+    const int64_t dir = yv > 0 ? 1 : -1;
+    const int64_t dx = yv >> i, dy = xv >> i;
+    xv += dir * dx;
+    yv -= dir * dy;
+    z  += dir * d::kAtan[i];
+  }
+  // What is left is below atan(2^-7), where atan(t) = t - t^3/3 to within
+  // 6e-12. |y| < 2^37 here, so scale x down rather than y up.
+  const int64_t t = (yv * (int64_t{1} << 22)) / (xv >> 8);
+  z += t - d::qmul(d::qmul(t, t), t) / 3;
+  if (z > d::kPiQ30)  z = d::kPiQ30;    // the last step can overshoot +-pi
+  if (z < -d::kPiQ30) z = -d::kPiQ30;
+  return d::from_q<Fx>(z, d::kQ);
+}
+
+// Batch forms: out[i] = f(in[i]) for i < n; `out` may alias an input.
+template <class Fx>
+inline void fixed_sin(std::size_t n, const Fx* x, Fx* out) { for (std::size_t i = 0; i < n; ++i) out[i] = fixed_sin(x[i]); }
+template <class Fx>
+inline void fixed_cos(std::size_t n, const Fx* x, Fx* out) { for (std::size_t i = 0; i < n; ++i) out[i] = fixed_cos(x[i]); }
+template <class Fx>
+inline void fixed_exp(std::size_t n, const Fx* x, Fx* out) { for (std::size_t i = 0; i < n; ++i) out[i] = fixed_exp(x[i]); }
+template <class Fx>
+inline void fixed_sqrt(std::size_t n, const Fx* x, Fx* out) { for (std::size_t i = 0; i < n; ++i) out[i] = fixed_sqrt(x[i]); }
+template <class Fx>
+inline void fixed_atan2(std::size_t n, const Fx* y, const Fx* x, Fx* out) {
+  for (std::size_t i = 0; i < n; ++i) out[i] = fixed_atan2(y[i], x[i]);
+}
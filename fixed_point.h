@@ -1,26 +1,283 @@
 // fixed_point.h
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <cmath>
+#include <limits>
+#include <type_traits>
 
-struct FP {
-  static constexpr int64_t SCALE = 1000;        // 3 decimal places
-  int64_t raw = 0;
+// How a result with more fraction bits than the type keeps is cut back.
+// Every mode is pure integer math, so all platforms agree bit for bit.
+enum class Round : uint8_t {
+  Floor,        // toward -inf; a plain arithmetic shift
+  TowardZero,   // what C++ integer division does
+  NearestEven,  // ties to even, no drift on repeated rounding
+};
+
+namespace fixed_detail {
+
+// Two's-complement 128-bit integer for compilers without __int128 (MSVC).
+// Only the operations FixedPoint needs; constexpr throughout.
+struct I128 {
+  uint64_t lo = 0, hi = 0;
+
+  constexpr I128() = default;
+  constexpr I128(int64_t v) : lo(static_cast<uint64_t>(v)), hi(v < 0 ? ~uint64_t{0} : 0) {}
+  static constexpr I128 make(uint64_t hi, uint64_t lo) { I128 r; r.hi = hi; r.lo = lo; return r; }
+
+  explicit constexpr operator int64_t() const { return static_cast<int64_t>(lo); }
+  constexpr bool negative() const { return (hi >> 63) != 0; }
+
+  friend constexpr I128 operator+(I128 a, I128 b) {
+    const uint64_t lo = a.lo + b.lo;
+    return make(a.hi + b.hi + (lo < a.lo), lo);
+  }
+  friend constexpr I128 operator-(I128 a) { return make(~a.hi, ~a.lo) + I128(1); }
+  friend constexpr I128 operator-(I128 a, I128 b) { return a + (-b); }
+  friend constexpr I128 operator&(I128 a, I128 b) { return make(a.hi & b.hi, a.lo & b.lo); }
+
+  // Low 128 bits of the product, which is the signed product when it fits.
+  friend constexpr I128 operator*(I128 a, I128 b) {
+    I128 r = mul64(a.lo, b.lo);
+    r.hi += a.lo * b.hi + a.hi * b.lo;
+    return r;
+  }
+
+  // Arithmetic shift, 0 <= s < 128.
+  friend constexpr I128 operator>>(I128 a, int s) {
+    const uint64_t sign = a.negative() ? ~uint64_t{0} : 0;
+    if (s == 0) return a;
+    if (s >= 64) return make(sign, s == 64 ? a.hi : (a.hi >> (s - 64)) | (sign << (128 - s)));
+    return make((a.hi >> s) | (sign << (64 - s)), (a.lo >> s) | (a.hi << (64 - s)));
+  }
+
+  // Truncating division and its remainder, like the built-in types.
+  friend constexpr I128 operator/(I128 a, I128 b) {
+    I128 q, r;
+    udivmod(abs(a), abs(b), q, r);
+    return a.negative() != b.negative() ? -q : q;
+  }
+  friend constexpr I128 operator%(I128 a, I128 b) {
+    I128 q, r;
+    udivmod(abs(a), abs(b), q, r);
+    return a.negative() ? -r : r;
+  }
 
-  static FP fromDouble(double x) { return FP{ (int64_t)llround(x * SCALE) }; }
-  static FP fromInt(int64_t x)   { return FP{ x * SCALE }; }
-  double toDouble() const        { return (double)raw / SCALE; }
+  friend constexpr bool operator==(I128 a, I128 b) { return a.hi == b.hi && a.lo == b.lo; }
+  friend constexpr bool operator!=(I128 a, I128 b) { return !(a == b); }
+  friend constexpr bool operator< (I128 a, I128 b) {
+    return a.hi != b.hi ? static_cast<int64_t>(a.hi) < static_cast<int64_t>(b.hi) : a.lo < b.lo;
+  }
+  friend constexpr bool operator> (I128 a, I128 b) { return b < a; }
+  friend constexpr bool operator<=(I128 a, I128 b) { return !(b < a); }
+  friend constexpr bool operator>=(I128 a, I128 b) { return !(a < b); }
 
-  // basic ops (all exact on the scaled integers)
-  FP& operator+=(FP o) { raw += o.raw; return *this; }
-  FP& operator-=(FP o) { raw -= o.raw; return *this; }
-  friend FP operator+(FP a, FP b){ return FP{a.raw + b.raw}; }
-  friend FP operator-(FP a, FP b){ return FP{a.raw - b.raw}; }
+private:
+  static constexpr I128 abs(I128 a) { return a.negative() ? -a : a; }
 
-  // multiply/divide by scalar (use with hours, counts, etc.)
-  friend FP operator*(FP a, int64_t k){ return FP{ a.raw * k }; }
-  friend FP operator/(FP a, int64_t k){ return FP{ a.raw / k }; }
+  static constexpr I128 mul64(uint64_t a, uint64_t b) {
+    const uint64_t a0 = a & 0xffffffffu, a1 = a >> 32, b0 = b & 0xffffffffu, b1 = b >> 32;
+    const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    const uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffu) + (p10 & 0xffffffffu);
+    return make(p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32), (mid << 32) | (p00 & 0xffffffffu));
+  }
 
-  // rare: fixed*fixed -> fixed (watch for overflow if values can be huge)
-  static FP mul(FP a, FP b){ return FP{ (a.raw * b.raw) / SCALE }; }
+  // Unsigned restoring division, one quotient bit per iteration. Slow, but
+  // only the fallback path of 64-bit division with a large numerator gets here.
+  static constexpr void udivmod(I128 n, I128 d, I128& q, I128& r) {
+    q = I128(); r = I128();
+    for (int i = 127; i >= 0; --i) {
+      const uint64_t bit = i >= 64 ? (n.hi >> (i - 64)) & 1 : (n.lo >> i) & 1;
+      r = make((r.hi << 1) | (r.lo >> 63), (r.lo << 1) | bit);
+      if (r.hi > d.hi || (r.hi == d.hi && r.lo >= d.lo)) {
+        r = r - d;
+        if (i >= 64) q.hi |= uint64_t{1} << (i - 64);
+        else         q.lo |= uint64_t{1} << i;
+      }
+    }
+  }
 };
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 int128;
+#else
+using int128 = I128;
+#endif
+
+// Signed type with room for the product of two Reps.
+template <class Rep> struct Wider;
+template <> struct Wider<int8_t>  { using type = int16_t; };
+template <> struct Wider<int16_t> { using type = int32_t; };
+template <> struct Wider<int32_t> { using type = int64_t; };
+template <> struct Wider<int64_t> { using type = int128; };
+
+} // namespace fixed_detail
+
+// Signed binary fixed point: raw * 2^-FracBits.
+//
+// Multiplication and division go through a type twice as wide, so the
+// intermediate never overflows; only the final narrowing can. The plain
+// operators wrap there like Rep itself, *_sat clamps to the range, and
+// *_checked reports failure and leaves `out` alone. operator* floors and
+// operator/ truncates toward zero; mul<R>/div<R> pick another Round.
+template <class Rep, int FracBits>
+struct FixedPoint {
+  static_assert(std::is_integral<Rep>::value && std::is_signed<Rep>::value, "Rep must be a signed integer");
+  static_assert(FracBits > 0 && FracBits < std::numeric_limits<Rep>::digits, "FracBits out of range");
+
+  using rep  = Rep;
+  using Wide = typename fixed_detail::Wider<Rep>::type;
+  static constexpr int kFracBits = FracBits;
+  static constexpr Rep SCALE     = Rep{1} << FracBits;
+  static constexpr Rep kMin      = std::numeric_limits<Rep>::min();
+  static constexpr Rep kMax      = std::numeric_limits<Rep>::max();
+
+  Rep raw = 0;
+
+  static constexpr FixedPoint fromRaw(Rep r)   { return FixedPoint{r}; }
+  static constexpr FixedPoint fromInt(Rep x)   { return FixedPoint{static_cast<Rep>(x * SCALE)}; }
+  static FixedPoint fromDouble(double x)       { return FixedPoint{static_cast<Rep>(std::llround(x * SCALE))}; }
+  constexpr double toDouble() const            { return static_cast<double>(raw) * (1.0 / static_cast<double>(SCALE)); }
+
+  static constexpr FixedPoint lowest() { return FixedPoint{kMin}; }
+  static constexpr FixedPoint max()    { return FixedPoint{kMax}; }
+
+  // basic ops (exact unless the result leaves the range)
+  constexpr FixedPoint& operator+=(FixedPoint o) { raw += o.raw; return *this; }
+  constexpr FixedPoint& operator-=(FixedPoint o) { raw -= o.raw; return *this; }
+  friend constexpr FixedPoint operator+(FixedPoint a, FixedPoint b) { return FixedPoint{static_cast<Rep>(a.raw + b.raw)}; }
+  friend constexpr FixedPoint operator-(FixedPoint a, FixedPoint b) { return FixedPoint{static_cast<Rep>(a.raw - b.raw)}; }
+  friend constexpr FixedPoint operator-(FixedPoint a)               { return FixedPoint{static_cast<Rep>(-a.raw)}; }
+
+  // multiply/divide by an integer (hours, counts, etc.)
+  friend constexpr FixedPoint operator*(FixedPoint a, Rep k) { return FixedPoint{static_cast<Rep>(a.raw * k)}; }
+  friend constexpr FixedPoint operator/(FixedPoint a, Rep k) { return FixedPoint{static_cast<Rep>(a.raw / k)}; }
+
+  // fixed*fixed and fixed/fixed
+  template <Round R = Round::Floor>
+  static constexpr FixedPoint mul(FixedPoint a, FixedPoint b) { return FixedPoint{narrow(mul_wide<R>(a, b))}; }
+  template <Round R = Round::TowardZero>
+  static constexpr FixedPoint div(FixedPoint a, FixedPoint b) { return FixedPoint{narrow(div_wide<R>(a, b))}; }
+
+  friend constexpr FixedPoint operator*(FixedPoint a, FixedPoint b) { return mul(a, b); }
+  friend constexpr FixedPoint operator/(FixedPoint a, FixedPoint b) { return div(a, b); }
+
+  // Saturating. Division by zero gives the end of the range on a's side (0 for 0/0).
+  static constexpr FixedPoint add_sat(FixedPoint a, FixedPoint b) { return FixedPoint{clamp_wide(Wide(a.raw) + Wide(b.raw))}; }
+  static constexpr FixedPoint sub_sat(FixedPoint a, FixedPoint b) { return FixedPoint{clamp_wide(Wide(a.raw) - Wide(b.raw))}; }
+  template <Round R = Round::Floor>
+  static constexpr FixedPoint mul_sat(FixedPoint a, FixedPoint b) { return FixedPoint{clamp_wide(mul_wide<R>(a, b))}; }
+  template <Round R = Round::TowardZero>
+  static constexpr FixedPoint div_sat(FixedPoint a, FixedPoint b) {
+    if (b.raw == 0) return FixedPoint{a.raw > 0 ? kMax : a.raw < 0 ? kMin : Rep{0}};
+    return FixedPoint{clamp_wide(div_wide<R>(a, b))};
+  }
+
+  // Checked: false on overflow or division by zero.
+  static constexpr bool add_checked(FixedPoint a, FixedPoint b, FixedPoint& out) { return store(Wide(a.raw) + Wide(b.raw), out); }
+  static constexpr bool sub_checked(FixedPoint a, FixedPoint b, FixedPoint& out) { return store(Wide(a.raw) - Wide(b.raw), out); }
+  template <Round R = Round::Floor>
+  static constexpr bool mul_checked(FixedPoint a, FixedPoint b, FixedPoint& out) { return store(mul_wide<R>(a, b), out); }
+  template <Round R = Round::TowardZero>
+  static constexpr bool div_checked(FixedPoint a, FixedPoint b, FixedPoint& out) {
+    return b.raw != 0 && store(div_wide<R>(a, b), out);
+  }
+
+  friend constexpr bool operator==(FixedPoint a, FixedPoint b) { return a.raw == b.raw; }
+  friend constexpr bool operator!=(FixedPoint a, FixedPoint b) { return a.raw != b.raw; }
+  friend constexpr bool operator< (FixedPoint a, FixedPoint b) { return a.raw <  b.raw; }
+  friend constexpr bool operator<=(FixedPoint a, FixedPoint b) { return a.raw <= b.raw; }
+  friend constexpr bool operator> (FixedPoint a, FixedPoint b) { return a.raw >  b.raw; }
+  friend constexpr bool operator>=(FixedPoint a, FixedPoint b) { return a.raw >= b.raw; }
+
+  // Exact product shifted back to FracBits, in the wide type.
+  template <Round R>
+  static constexpr Wide mul_wide(FixedPoint a, FixedPoint b) {
+    const Wide p = Wide(a.raw) * Wide(b.raw);
+    Wide q = p >> FracBits;                       // floor
+    if constexpr (R != Round::Floor) {
+      const Wide rem = p & Wide(SCALE - 1);       // p - q * SCALE, in [0, SCALE)
+      if constexpr (R == Round::TowardZero) {
+        if (p < Wide(0) && rem != Wide(0)) q = q + Wide(1);
+      } else {
+        const Wide half = Wide(SCALE / 2);
+        if (rem > half || (rem == half && (q & Wide(1)) != Wide(0))) q = q + Wide(1);
+      }
+    }
+    return q;
+  }
+
+  // (a << FracBits) / b, rounded; b != 0.
+  template <Round R>
+  static constexpr Wide div_wide(FixedPoint a, FixedPoint b) {
+    if constexpr (sizeof(Rep) == 8) {
+      // The 128-bit divide is a library call (a bit loop without __int128);
+      // most numerators fit in 64 bits once scaled.
+      if (a.raw <= (kMax >> FracBits) && a.raw >= -(kMax >> FracBits) && b.raw != kMin) {
+        return Wide(div_round<R>(static_cast<Rep>(a.raw * SCALE), b.raw));
+      }
+    }
+    return div_round<R>(Wide(a.raw) * Wide(SCALE), Wide(b.raw));
+  }
+
+private:
+  template <Round R, class T>
+  static constexpr T div_round(T n, T d) {
+    T q = n / d;
+    if constexpr (R != Round::TowardZero) {
+      const T rem = n - q * d;
+      if (rem != T(0)) {
+        const bool negative = (n < T(0)) != (d < T(0));
+        if constexpr (R == Round::Floor) {
+          if (negative) q = q - T(1);
+        } else {
+          // Compare |rem| with |d| - |rem| so nothing is doubled past the type.
+          const T r = rem < T(0) ? T(0) - rem : rem;
+          const T a = d < T(0) ? T(0) - d : d;
+          if (r > a - r || (r == a - r && (q & T(1)) != T(0))) q = negative ? q - T(1) : q + T(1);
+        }
+      }
+    }
+    return q;
+  }
+
+  static constexpr Rep narrow(Wide w) { return static_cast<Rep>(w); }
+  static constexpr Rep clamp_wide(Wide w) { return w < Wide(kMin) ? kMin : w > Wide(kMax) ? kMax : narrow(w); }
+  static constexpr bool store(Wide w, FixedPoint& out) {
+    if (w < Wide(kMin) || w > Wide(kMax)) return false;
+    out = FixedPoint{narrow(w)};
+    return true;
+  }
+};
+
+// Array kernels, out[i] = op(a[i], ...) for i < n. The loops have no
+// cross-lane dependencies so the compiler can vectorise them where the
+// target has the multiplies (32-bit Reps on SSE4.1/AVX2). `out` may alias
+// an input. add wraps and mul narrows like the scalar operators.
+template <class Rep, int F>
+inline void fixed_add(std::size_t n, const FixedPoint<Rep, F>* a, const FixedPoint<Rep, F>* b,
+                      FixedPoint<Rep, F>* out) {
+  using U = std::make_unsigned_t<Rep>;   // wrap without signed-overflow UB
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i].raw = static_cast<Rep>(static_cast<U>(a[i].raw) + static_cast<U>(b[i].raw));
+  }
+}
+
+template <Round R = Round::Floor, class Rep, int F>
+inline void fixed_mul(std::size_t n, const FixedPoint<Rep, F>* a, const FixedPoint<Rep, F>* b,
+                      FixedPoint<Rep, F>* out) {
+  for (std::size_t i = 0; i < n; ++i) out[i] = FixedPoint<Rep, F>::template mul<R>(a[i], b[i]);
+}
+
+template <class Rep, int F>
+inline void fixed_clamp(std::size_t n, const FixedPoint<Rep, F>* a, FixedPoint<Rep, F> lo,
+                        FixedPoint<Rep, F> hi, FixedPoint<Rep, F>* out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    const Rep v = a[i].raw;
+    out[i].raw = v < lo.raw ? lo.raw : v > hi.raw ? hi.raw : v;
+  }
+}
+
+// The sim's general-purpose fixed type: Q47.16, resolution ~1.5e-5, range
+// ~±1.4e14. Keeps the old FP interface (raw, SCALE, fromDouble, mul, ...).
+using FP = FixedPoint<int64_t, 16>;
@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+
+namespace mars {
+
+// Per-tick bump arena for simulation temporaries (forecast series, query
+// results, command lists...). Hand it to std::pmr containers; everything
+// allocated from it dies together at reset(), called at the end of a tick or
+// after a forecast has been consumed.
+//
+// Allocation is a pointer bump. When the current block runs out we chain an
+// overflow block from upstream; reset() then folds all blocks into a single
+// one big enough for the high-water mark, so a steady-state tick makes no
+// upstream (global operator new) calls at all.
+//
+// Debug builds poison memory on deallocate (0xDD) and on reset (0xCD) so
+// use-after-tick bugs show up as garbage instead of stale-but-plausible data.
+class FrameArena final : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(std::size_t initialBytes = 64 * 1024,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {
+        if (initialBytes) head_ = newBlock(initialBytes, nullptr);
+        resetCursor();
+    }
+
+    ~FrameArena() override { releaseAll(); }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void reset() {
+        const std::size_t want = highWater_;
+        if (head_ && head_->next) {
+            // Grew this frame: replace the chain with one block that fits it.
+            releaseAll();
+            head_ = newBlock(roundUp(want), nullptr);
+        }
+#ifndef NDEBUG
+        if (head_) std::memset(payload(head_), 0xCD, head_->size);
+#endif
+        resetCursor();
+    }
+
+    std::size_t used() const           { return used_; }
+    std::size_t highWater() const      { return highWater_; }
+    std::size_t capacity() const       { return head_ ? head_->size : 0; }
+    std::size_t upstreamAllocs() const { return upstreamAllocs_; }
+
+private:
+    struct Block {
+        Block*      next;
+        std::size_t size; // payload bytes
+    };
+
+    static constexpr std::size_t kHeader = (sizeof(Block) + alignof(std::max_align_t) - 1)
+                                         & ~(alignof(std::max_align_t) - 1);
+
+    static unsigned char* payload(Block* b) { return reinterpret_cast<unsigned char*>(b) + kHeader; }
+
+    static std::size_t roundUp(std::size_t n) {
+        std::size_t p = 4096;
+        while (p < n) p *= 2;
+        return p;
+    }
+
+    Block* newBlock(std::size_t size, Block* next) {
+        void* mem = upstream_->allocate(kHeader + size, alignof(std::max_align_t));
+        ++upstreamAllocs_;
+        return ::new (mem) Block{next, size};
+    }
+
+    void releaseAll() {
+        while (head_) {
+            Block* next = head_->next;
+            upstream_->deallocate(head_, kHeader + head_->size, alignof(std::max_align_t));
+            head_ = next;
+        }
+    }
+
+    void resetCursor() {
+        cur_  = head_ ? payload(head_) : nullptr;
+        end_  = head_ ? cur_ + head_->size : nullptr;
+        used_ = 0;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        auto p = reinterpret_cast<std::uintptr_t>(cur_);
+        std::uintptr_t aligned = (p + (align - 1)) & ~static_cast<std::uintptr_t>(align - 1);
+        if (!cur_ || aligned + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+            const std::size_t want = bytes + align;
+            const std::size_t size = roundUp(want > capacity() ? want * 2 : capacity() * 2);
+            head_ = newBlock(size, head_);
+            cur_  = payload(head_);
+            end_  = cur_ + size;
+            p       = reinterpret_cast<std::uintptr_t>(cur_);
+            aligned = (p + (align - 1)) & ~static_cast<std::uintptr_t>(align - 1);
+        }
+        const std::size_t consumed = (aligned - p) + bytes;
+        cur_ += consumed;
+        used_ += consumed;
+        if (used_ > highWater_) highWater_ = used_;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t) override {
+        // Memory is reclaimed wholesale at reset().
+#ifndef NDEBUG
+        std::memset(p, 0xDD, bytes);
+#else
+        (void)p; (void)bytes;
+#endif
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    Block*         head_ = nullptr;
+    unsigned char* cur_  = nullptr;
+    unsigned char* end_  = nullptr;
+    std::size_t    used_ = 0;
+    std::size_t    highWater_ = 0;
+    std::size_t    upstreamAllocs_ = 0;
+};
+
+} // namespace mars
@@ -0,0 +1,237 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace mars {
+
+// Fixed-size log-linear (HDR-style) histogram of nanosecond durations.
+//
+// Values below kSub are counted exactly; above that every power-of-two range
+// is split into kSub equal sub-buckets, so any reported value is within
+// 1/kSub (3.1%) of the true one. Values past 2^kMaxBits ns (~4.9 h) clamp to
+// the last bucket. Counters are relaxed atomics: recording is lock-free and a
+// reporter may merge while writers are running.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBits = 5;
+    static constexpr unsigned kSub     = 1u << kSubBits;
+    static constexpr unsigned kMaxBits = 44;
+    static constexpr unsigned kBuckets = (kMaxBits - kSubBits + 1) * kSub;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram& o) { merge(o); }
+    LatencyHistogram& operator=(const LatencyHistogram& o) {
+        if (this != &o) { reset(); merge(o); }
+        return *this;
+    }
+
+    void record(uint64_t ns) noexcept {
+        counts_[index(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+        raise(max_, ns);
+    }
+
+    void merge(const LatencyHistogram& o) noexcept {
+        for (unsigned i = 0; i < kBuckets; ++i) {
+            const uint64_t c = o.counts_[i].load(std::memory_order_relaxed);
+            if (c) counts_[i].fetch_add(c, std::memory_order_relaxed);
+        }
+        count_.fetch_add(o.count(), std::memory_order_relaxed);
+        sum_.fetch_add(o.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        raise(max_, o.max());
+    }
+
+    void reset() noexcept {
+        for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+    uint64_t max()   const noexcept { return max_.load(std::memory_order_relaxed); }
+    uint64_t mean()  const noexcept {
+        const uint64_t n = count();
+        return n ? sum_.load(std::memory_order_relaxed) / n : 0;
+    }
+
+    // Smallest recorded-bucket upper bound with at least q of the samples at
+    // or below it, clamped to the observed max. q in [0, 1].
+    uint64_t quantile(double q) const noexcept {
+        const uint64_t n = count();
+        if (n == 0) return 0;
+        q = std::min(1.0, std::max(0.0, q));
+        uint64_t target = static_cast<uint64_t>(q * static_cast<double>(n) + 0.5);
+        if (target < 1) target = 1;
+        uint64_t seen = 0;
+        for (unsigned i = 0; i < kBuckets; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= target) return std::min(upper(i), max());
+        }
+        return max();
+    }
+
+    static unsigned index(uint64_t v) noexcept {
+        if (v < kSub) return static_cast<unsigned>(v);
+        const uint64_t top = (uint64_t{1} << kMaxBits) - 1;
+        if (v > top) v = top;
+        unsigned msb = 63;
+        while (!(v >> msb)) --msb;                     // msb >= kSubBits here
+        const unsigned shift = msb - kSubBits;
+        const unsigned group = shift + 1;
+        return group * kSub + static_cast<unsigned>((v >> shift) - kSub);
+    }
+
+    // Largest value that maps to bucket i.
+    static uint64_t upper(unsigned i) noexcept {
+        const unsigned group = i / kSub, sub = i % kSub;
+        if (group == 0) return sub;
+        const unsigned shift = group - 1;
+        return ((uint64_t{kSub} + sub + 1) << shift) - 1;
+    }
+
+private:
+    static void raise(std::atomic<uint64_t>& a, uint64_t v) noexcept {
+        uint64_t cur = a.load(std::memory_order_relaxed);
+        while (v > cur && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+    }
+
+    std::atomic<uint64_t> counts_[kBuckets] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// A named duration metric. Each recording thread gets its own histogram
+// shard, allocated on its first record(), so hot-path threads never share
+// cache lines; snapshot() merges the shards.
+class LatencyMetric {
+public:
+    static constexpr unsigned kMaxShards = 64;   // more threads share shards
+
+    explicit LatencyMetric(std::string name) : name_(std::move(name)) {}
+    ~LatencyMetric() {
+        for (auto& s : shards_) delete s.load(std::memory_order_relaxed);
+    }
+
+    LatencyMetric(const LatencyMetric&) = delete;
+    LatencyMetric& operator=(const LatencyMetric&) = delete;
+
+    void record(uint64_t ns) { shard().record(ns); }
+
+    LatencyHistogram snapshot() const {
+        LatencyHistogram h;
+        for (const auto& s : shards_) {
+            if (const LatencyHistogram* p = s.load(std::memory_order_acquire)) h.merge(*p);
+        }
+        return h;
+    }
+
+    void reset() {
+        for (auto& s : shards_) {
+            if (LatencyHistogram* p = s.load(std::memory_order_acquire)) p->reset();
+        }
+    }
+
+    const std::string& name() const { return name_; }
+
+private:
+    static unsigned thread_slot() {
+        static std::atomic<unsigned> next{0};
+        thread_local const unsigned slot = next.fetch_add(1, std::memory_order_relaxed) % kMaxShards;
+        return slot;
+    }
+
+    LatencyHistogram& shard() {
+        std::atomic<LatencyHistogram*>& s = shards_[thread_slot()];
+        LatencyHistogram* p = s.load(std::memory_order_acquire);
+        if (!p) {
+            auto* fresh = new LatencyHistogram();
+            if (s.compare_exchange_strong(p, fresh, std::memory_order_acq_rel)) p = fresh;
+            else delete fresh;   // a thread sharing this slot got there first
+        }
+        return *p;
+    }
+
+    std::string                    name_;
+    std::atomic<LatencyHistogram*> shards_[kMaxShards] = {};
+};
+
+// Process-wide set of metrics. Look a metric up once (it never moves) and
+// keep the reference; get() takes a lock.
+class LatencyRegistry {
+public:
+    LatencyMetric& get(const std::string& name) {
+        std::lock_guard<std::mutex> lk(m_);
+        for (auto& met : metrics_) {
+            if (met.name() == name) return met;
+        }
+        metrics_.emplace_back(name);
+        return metrics_.back();
+    }
+
+    // One line per metric: name count p50 p99 p99.9 max, in microseconds.
+    std::string report() const {
+        std::lock_guard<std::mutex> lk(m_);
+        std::string out;
+        char line[192];
+        for (const auto& met : metrics_) {
+            const LatencyHistogram h = met.snapshot();
+            std::snprintf(line, sizeof line,
+                          "%-24s n=%-10" PRIu64 " p50=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus\n",
+                          met.name().c_str(), h.count(),
+                          static_cast<double>(h.quantile(0.50)) / 1e3,
+                          static_cast<double>(h.quantile(0.99)) / 1e3,
+                          static_cast<double>(h.quantile(0.999)) / 1e3,
+                          static_cast<double>(h.max()) / 1e3);
+            out += line;
+        }
+        return out;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lk(m_);
+        for (auto& met : metrics_) met.reset();
+    }
+
+private:
+    mutable std::mutex        m_;
+    std::deque<LatencyMetric> metrics_;
+};
+
+inline LatencyRegistry& latency_registry() {
+    static LatencyRegistry r;
+    return r;
+}
+
+inline LatencyMetric& latency_metric(const std::string& name) {
+    return latency_registry().get(name);
+}
+
+// Records the lifetime of the scope into `m`.
+class ScopedLatency {
+public:
+    using Clock = std::chrono::steady_clock;
+    explicit ScopedLatency(LatencyMetric& m) : m_(m), t0_(Clock::now()) {}
+    ~ScopedLatency() {
+        const auto dt = Clock::now() - t0_;
+        m_.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count()));
+    }
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyMetric&    m_;
+    Clock::time_point t0_;
+};
+
+} // namespace mars
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "types.hpp"
+
+// Per-type building instances as a sparse set over struct-of-arrays columns.
+//
+// Handles index `sparse_`, which points at the instance's dense row; rows
+// are packed 0..size() and removal swaps the last row into the hole, so the
+// columns stay contiguous for whole-type passes. A generation per handle
+// slot makes handles to removed instances stale instead of aliasing a
+// newer building.
+//
+// State is Q16 (kFull == 1.0). An instance's efficiency is
+// health × (1 - dust); every edit returns the change in efficiency so the
+// caller can move its running totals by the delta instead of re-summing.
+class BuildingPool {
+public:
+    static constexpr int32_t  kFull = 1 << 16;
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Handle {
+        uint32_t slot{kNone};
+        uint32_t gen{0};
+    };
+
+    // Dense columns, one row per live instance; edit through set().
+    const std::vector<int32_t>& health() const { return health_; }
+    const std::vector<int32_t>& dust() const { return dust_; }
+    const std::vector<int32_t>& eff() const { return eff_; }
+
+    size_t  size() const { return slot_.size(); }
+    int64_t effSum() const { return effSum_; }  // Σ eff over rows
+
+    // New instance at full health, clean. Its efficiency is kFull.
+    Handle add() {
+        uint32_t s;
+        if (!free_.empty()) {
+            s = free_.back();
+            free_.pop_back();
+        } else {
+            s = static_cast<uint32_t>(sparse_.size());
+            sparse_.push_back(kNone);
+            gen_.push_back(1);
+        }
+        sparse_[s] = static_cast<uint32_t>(slot_.size());
+        slot_.push_back(s);
+        health_.push_back(kFull);
+        dust_.push_back(0);
+        eff_.push_back(kFull);
+        effSum_ += kFull;
+        return Handle{s, gen_[s]};
+    }
+
+    bool valid(Handle h) const {
+        return h.slot < sparse_.size() && sparse_[h.slot] != kNone && gen_[h.slot] == h.gen;
+    }
+
+    Handle handleAt(size_t r) const { return Handle{slot_[r], gen_[slot_[r]]}; }
+    size_t row(Handle h) const { return sparse_[h.slot]; }  // requires valid(h)
+
+    // Removes a live instance; returns minus its efficiency.
+    int32_t remove(Handle h) {
+        const size_t r = row(h);
+        const int32_t delta = -eff_[r];
+        const size_t last = slot_.size() - 1;
+        if (r != last) {
+            slot_[r]   = slot_[last];
+            health_[r] = health_[last];
+            dust_[r]   = dust_[last];
+            eff_[r]    = eff_[last];
+            sparse_[slot_[r]] = static_cast<uint32_t>(r);
+        }
+        slot_.pop_back();
+        health_.pop_back();
+        dust_.pop_back();
+        eff_.pop_back();
+        sparse_[h.slot] = kNone;
+        if (++gen_[h.slot] == 0) gen_[h.slot] = 1;
+        free_.push_back(h.slot);
+        effSum_ += delta;
+        return delta;
+    }
+
+    // Sets one row's state (clamped to [0, kFull]); returns the efficiency delta.
+    int32_t set(size_t r, int32_t newHealth, int32_t newDust) {
+        health_[r] = clampQ(newHealth);
+        dust_[r]   = clampQ(newDust);
+        const int32_t e = efficiency(health_[r], dust_[r]);
+        const int32_t delta = e - eff_[r];
+        eff_[r] = e;
+        effSum_ += delta;
+        return delta;
+    }
+
+    // Adds dust to every row (a storm settling); returns the summed delta.
+    int64_t depositAll(int32_t amount) {
+        int64_t delta = 0;
+        for (size_t r = 0; r < slot_.size(); ++r) delta += set(r, health_[r], dust_[r] + amount);
+        return delta;
+    }
+
+    static int32_t efficiency(int32_t h, int32_t d) {
+        return static_cast<int32_t>((static_cast<int64_t>(h) * (kFull - d)) >> 16);
+    }
+
+private:
+    static int32_t clampQ(int32_t v) { return v < 0 ? 0 : v > kFull ? kFull : v; }
+
+    std::vector<uint32_t> slot_;    // row -> handle slot
+    std::vector<int32_t>  health_;  // Q16, 0 = wrecked
+    std::vector<int32_t>  dust_;    // Q16, 0 = clean
+    std::vector<int32_t>  eff_;     // Q16, cached health × (1 - dust)
+    std::vector<uint32_t> sparse_;  // handle slot -> row, kNone when free
+    std::vector<uint32_t> gen_;
+    std::vector<uint32_t> free_;
+    int64_t               effSum_{0};
+};
+
+struct BuildingId {
+    BuildingType         type{BuildingType::COUNT};
+    BuildingPool::Handle h{};
+};
@@ -1,5 +1,6 @@
 #pragma once
-#include <map>
+#include <array>
+#include <cstdint>
 #include <vector>
 #include "types.hpp"
 
@@ -11,17 +12,150 @@ struct Command {
     int a{0}; // For Build: static_cast<int>(BuildingType)
 };
 
-// Simple time-indexed queue; keeps your “apply at hour start” rule.
-struct CommandQueue {
-    std::multimap<Hours, Command> pending;
-    void submit(const Command& c) { pending.emplace(c.hour, c); }
-    // iterate [hour, hour] range and apply
+// Time-indexed queue; keeps your “apply at hour start” rule.
+//
+// A hierarchical timing wheel over pooled nodes: level 0 has one bucket per
+// hour of the current 256-hour block, each level above covers 64x the span
+// of the one below, and anything past level 3 (~7,600 years out) waits in an
+// overflow list. An order lives on the level of the highest time block it
+// doesn't share with the wheel's clock; crossing into a block moves that
+// block's bucket down a level (a cascade). So:
+//   - submit is O(1) and allocation-free once the pool has grown,
+//   - draining costs O(orders due) plus O(1) per hour advanced, or per
+//     256-hour block while level 0 is empty,
+//   - memory is the fixed buckets plus one node per pending order, however
+//     far ahead orders are scheduled.
+// All orders for one hour always share a bucket and buckets are FIFO, so
+// orders for the same hour come out in submission order.
+class CommandQueue {
+public:
+    void submit(const Command& c) {
+        const uint32_t n = alloc(c);
+        push(bucketFor(c.hour), n);
+        ++size_;
+    }
+
+    // Applies every order due at or before `h` that hasn't run yet, hour by
+    // hour, FIFO within an hour. Orders submitted for an hour that has
+    // already been drained run on the next drain instead of being stranded;
+    // ones `apply` submits for hours <= h run in this drain.
     template <class Fn>
     void drain_for_hour(Hours h, Fn&& apply) {
-        auto range = pending.equal_range(h);
-        for (auto it = range.first; it != range.second; ++it) {
-            apply(it->second);
+        while (now_ <= h) {
+            if (size_ == 0) {  // nothing to cascade: jump the clock
+                now_ = h + 1;
+                return;
+            }
+            if (size0_ == 0) {  // skip to the last hour of this block
+                const Hours last = now_ | kMask0;
+                now_ = last < h ? last : h;
+            }
+            Bucket& b = level0_[slot(now_, 0)];
+            while (b.head != kNil) {
+                const uint32_t n = b.head;
+                b.head = nodes_[n].next;
+                if (b.head == kNil) b.tail = kNil;
+                const Command c = nodes_[n].cmd;
+                release(n);
+                --size_;
+                --size0_;
+                apply(c);  // may submit; nodes_ may reallocate
+            }
+            advance();
+        }
+    }
+
+    size_t size() const { return size_; }
+    bool   empty() const { return size_ == 0; }
+    Hours  next_hour() const { return now_; }  // first hour not yet drained
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static constexpr int kBits0 = 8;   // level 0: 256 one-hour buckets
+    static constexpr int kBitsN = 6;   // levels 1..3: 64 buckets each
+    static constexpr int kLevels = 4;
+    static constexpr Hours kMask0 = (Hours{1} << kBits0) - 1;
+
+    struct Node {
+        Command  cmd;
+        uint32_t next{kNil};
+    };
+    struct Bucket {
+        uint32_t head{kNil};
+        uint32_t tail{kNil};
+    };
+
+    // Bits of the hour below level `lvl`'s bucket index.
+    static constexpr int shift(int lvl) { return lvl == 0 ? 0 : kBits0 + (lvl - 1) * kBitsN; }
+    static constexpr int width(int lvl) { return lvl == 0 ? kBits0 : kBitsN; }
+    static size_t slot(Hours h, int lvl) {
+        return static_cast<size_t>(static_cast<uint64_t>(h) >> shift(lvl)) & ((size_t{1} << width(lvl)) - 1);
+    }
+
+    Bucket& bucketFor(Hours h) {
+        if (h < now_) h = now_;  // late: next drain
+        for (int lvl = 0; lvl < kLevels; ++lvl) {
+            const int above = shift(lvl) + width(lvl);
+            if ((h >> above) == (now_ >> above)) {
+                return lvl == 0 ? level0_[slot(h, 0)] : upper_[lvl - 1][slot(h, lvl)];
+            }
         }
-        pending.erase(range.first, range.second);
+        return overflow_;
+    }
+
+    void push(Bucket& b, uint32_t n) {
+        if (&b >= level0_.data() && &b < level0_.data() + level0_.size()) ++size0_;
+        nodes_[n].next = kNil;
+        if (b.tail == kNil) b.head = n;
+        else nodes_[b.tail].next = n;
+        b.tail = n;
     }
+
+    // Re-files a bucket's orders against the current clock, in order.
+    void cascade(Bucket& from) {
+        uint32_t n = from.head;
+        from = Bucket{};
+        while (n != kNil) {
+            const uint32_t next = nodes_[n].next;
+            push(bucketFor(nodes_[n].cmd.hour), n);
+            n = next;
+        }
+    }
+
+    // Steps the clock one hour, cascading every block boundary it crosses,
+    // outermost first so each level is filled before it is split.
+    void advance() {
+        ++now_;
+        if (now_ & kMask0) return;
+        if ((now_ & ((Hours{1} << shift(kLevels)) - 1)) == 0) cascade(overflow_);
+        for (int lvl = kLevels - 1; lvl >= 1; --lvl) {
+            if ((now_ & ((Hours{1} << shift(lvl)) - 1)) == 0) cascade(upper_[lvl - 1][slot(now_, lvl)]);
+        }
+    }
+
+    uint32_t alloc(const Command& c) {
+        uint32_t n;
+        if (free_ != kNil) {
+            n = free_;
+            free_ = nodes_[n].next;
+        } else {
+            n = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back(Node{});
+        }
+        nodes_[n].cmd = c;
+        return n;
+    }
+    void release(uint32_t n) {
+        nodes_[n].next = free_;
+        free_ = n;
+    }
+
+    std::array<Bucket, size_t{1} << kBits0> level0_{};
+    std::array<std::array<Bucket, size_t{1} << kBitsN>, kLevels - 1> upper_{};
+    Bucket            overflow_{};
+    std::vector<Node> nodes_;   // pool; freed nodes chain through `next`
+    uint32_t          free_{kNil};
+    size_t            size_{0};
+    size_t            size0_{0};  // of which on level 0
+    Hours             now_{0};
 };
@@ -1,6 +1,6 @@
 // sim.cpp
 #include "sim.hpp"
-#include <iostream>
+#include <cmath>
 
 void Game::step() {
     // Apply commands scheduled for THIS hour before events/simulation (matches your current order)
@@ -11,6 +11,285 @@ void Game::step() {
     });
     maybeSpawnEvents();
     simulateHour();
-    tickEffects();
     ++s.hour;
 }
+
+bool Game::tryBuild(BuildingType t, BuildingId* built) {
+    if (t != BuildingType::Extractor) return tryBuildAt(t, 0, 0, built);
+    const int32_t r = siteSearchRadius;
+    const mars::deposits::Site site = deposits().best_site(mars::deposits::Resource::Metals, -r, -r, r + 1, r + 1);
+    return tryBuildAt(t, site.x, site.y, built);
+}
+
+bool Game::tryBuildAt(BuildingType t, int32_t x, int32_t y, BuildingId* built) {
+    if (to_index(t) >= to_index(BuildingType::COUNT)) return false;
+    const BuildingSpec& spec = getSpec(t);
+    if (s.credits < spec.credits_cost || s.metals < spec.metals_cost) return false;
+    s.credits -= spec.credits_cost;
+    s.metals  -= spec.metals_cost;
+
+    const SpecWatts& w = SPEC_WATTS[to_index(t)];
+    const BuildingPool::Handle h = s.buildings[to_index(t)].add();
+    ++s.count[to_index(t)];
+    s.totals.load_w   += w.load_w;
+    s.totals.upkeep_w += w.upkeep_w;
+    if (t == BuildingType::Greenhouse) s.plots.addBlock(crops.seedKg, 0.5 * crops.fieldCapacityL, irrigationLPerH);
+    if (t == BuildingType::Reactor) {
+        s.reactors.push_back(mars::reactor::steady(0.0, 1.0, reactor));
+        s.reactorsDirty = true;
+    }
+    if (t == BuildingType::Extractor) {
+        s.sites.add(x, y, deposits().richness(mars::deposits::Resource::Ice, x, y),
+                    deposits().richness(mars::deposits::Resource::Metals, x, y));
+    }
+    applyEffDelta(t, BuildingPool::kFull, s.buildings[to_index(t)].row(h));
+    if (built) *built = BuildingId{t, h};
+    return true;
+}
+
+bool Game::destroy(BuildingType t) {
+    if (to_index(t) >= to_index(BuildingType::COUNT) || s.count[to_index(t)] == 0) return false;
+    const BuildingPool& pool = s.buildings[to_index(t)];
+    return destroy(BuildingId{t, pool.handleAt(pool.size() - 1)});
+}
+
+bool Game::destroy(BuildingId id) {
+    if (to_index(id.type) >= to_index(BuildingType::COUNT)) return false;
+    BuildingPool& pool = s.buildings[to_index(id.type)];
+    if (!pool.valid(id.h)) return false;
+    const SpecWatts& w = SPEC_WATTS[to_index(id.type)];
+    const size_t r = pool.row(id.h);
+    applyEffDelta(id.type, -pool.eff()[r], r);
+    if (id.type == BuildingType::Greenhouse) s.plots.removeBlock(r);
+    if (id.type == BuildingType::Extractor) s.sites.remove(r);
+    if (id.type == BuildingType::Reactor) {
+        s.reactors[r] = s.reactors.back();
+        s.reactors.pop_back();
+        s.reactorsDirty = true;
+    }
+    pool.remove(id.h);
+    --s.count[to_index(id.type)];
+    s.totals.load_w   -= w.load_w;
+    s.totals.upkeep_w -= w.upkeep_w;
+    return true;
+}
+
+bool Game::damage(BuildingId id, int32_t amount) {
+    if (to_index(id.type) >= to_index(BuildingType::COUNT)) return false;
+    BuildingPool& pool = s.buildings[to_index(id.type)];
+    if (!pool.valid(id.h)) return false;
+    const size_t r = pool.row(id.h);
+    if (pool.health()[r] <= amount) return destroy(id);
+    applyEffDelta(id.type, pool.set(r, pool.health()[r] - amount, pool.dust()[r]), r);
+    syncHealth(id);
+    return true;
+}
+
+bool Game::repair(BuildingId id) {
+    if (to_index(id.type) >= to_index(BuildingType::COUNT)) return false;
+    BuildingPool& pool = s.buildings[to_index(id.type)];
+    if (!pool.valid(id.h)) return false;
+    const size_t r = pool.row(id.h);
+    // Metals for the missing share of the build cost, rounded up.
+    const int64_t missing = BuildingPool::kFull - pool.health()[r];
+    const int cost = static_cast<int>((missing * getSpec(id.type).metals_cost + BuildingPool::kFull - 1) /
+                                      BuildingPool::kFull);
+    if (s.metals < cost) return false;
+    s.metals -= cost;
+    applyEffDelta(id.type, pool.set(r, BuildingPool::kFull, pool.dust()[r]), r);
+    syncHealth(id);
+    if (mars::reactor::Core* c = core(id)) mars::reactor::reset_scram(*c, reactor);
+    return true;
+}
+
+bool Game::clean(BuildingId id) {
+    if (to_index(id.type) >= to_index(BuildingType::COUNT)) return false;
+    BuildingPool& pool = s.buildings[to_index(id.type)];
+    if (!pool.valid(id.h)) return false;
+    const size_t r = pool.row(id.h);
+    applyEffDelta(id.type, pool.set(r, pool.health()[r], 0), r);
+    syncHealth(id);
+    return true;
+}
+
+void Game::depositDust(BuildingType t, int32_t amount) {
+    if (to_index(t) >= to_index(BuildingType::COUNT)) return;
+    BuildingPool& pool = s.buildings[to_index(t)];
+    if (t != BuildingType::Extractor) {
+        applyEffDelta(t, pool.depositAll(amount), 0);
+        if (t == BuildingType::Reactor) {
+            for (size_t r = 0; r < pool.size(); ++r) syncHealth(BuildingId{t, pool.handleAt(r)});
+        }
+        return;
+    }
+    // Extractor yield is weighted by each row's site, so row by row.
+    for (size_t r = 0; r < pool.size(); ++r) {
+        applyEffDelta(t, pool.set(r, pool.health()[r], pool.dust()[r] + amount), r);
+    }
+}
+
+bool Game::setReactorRods(BuildingId id, double insertion) {
+    mars::reactor::Core* c = core(id);
+    if (!c) return false;
+    mars::reactor::command_rods(*c, insertion);
+    s.reactorsDirty = true;
+    return true;
+}
+
+bool Game::resetScram(BuildingId id) {
+    mars::reactor::Core* c = core(id);
+    if (!c || !mars::reactor::reset_scram(*c, reactor)) return false;
+    s.reactorsDirty = true;
+    return true;
+}
+
+// SPEC generation per instance; reactors generate through their cores.
+static long long spec_gen_w(size_t type) {
+    return type == to_index(BuildingType::Reactor) ? 0 : SPEC_WATTS[type].gen_w;
+}
+
+// Site richness truncated to Q16, so the extractor sums stay integers.
+static long long richness_q(float r) {
+    return static_cast<long long>(r * BuildingPool::kFull);
+}
+
+void Game::applyEffDelta(BuildingType t, int64_t delta, size_t row) {
+    s.totals.gen_wq += spec_gen_w(to_index(t)) * delta;
+    if (t == BuildingType::Extractor) {
+        s.totals.ice_qq    += richness_q(s.sites.ice[row]) * delta;
+        s.totals.metals_qq += richness_q(s.sites.metals[row]) * delta;
+    }
+}
+
+void Game::syncHealth(BuildingId id) {
+    const BuildingPool& pool = s.buildings[to_index(id.type)];
+    const size_t r = pool.row(id.h);
+    const double health = static_cast<double>(pool.health()[r]) / BuildingPool::kFull;
+    if (id.type == BuildingType::Greenhouse) s.plots.setLight(r, health);
+    if (id.type == BuildingType::Reactor) {
+        // Dust on the radiators cuts cooling as damage does.
+        mars::reactor::set_cooling(s.reactors[r], static_cast<double>(pool.eff()[r]) / BuildingPool::kFull);
+        s.reactorsDirty = true;
+    }
+}
+
+mars::reactor::Core* Game::core(BuildingId id) {
+    if (id.type != BuildingType::Reactor) return nullptr;
+    const BuildingPool& pool = s.buildings[to_index(id.type)];
+    return pool.valid(id.h) ? &s.reactors[pool.row(id.h)] : nullptr;
+}
+
+void Game::recomputeTotals() {
+    s.totals = BuildingTotals{};
+    for (size_t i = 0; i < SPEC_WATTS.size(); ++i) {
+        const BuildingPool& pool = s.buildings[i];
+        int64_t eff = 0;
+        for (int32_t e : pool.eff()) eff += e;
+        s.count[i] = static_cast<int>(pool.size());
+        s.totals.gen_wq   += spec_gen_w(i) * eff;
+        s.totals.load_w   += s.count[i] * SPEC_WATTS[i].load_w;
+        s.totals.upkeep_w += s.count[i] * SPEC_WATTS[i].upkeep_w;
+    }
+    const BuildingPool& ex = s.buildings[to_index(BuildingType::Extractor)];
+    for (size_t r = 0; r < ex.size(); ++r) {
+        s.totals.ice_qq    += richness_q(s.sites.ice[r]) * ex.eff()[r];
+        s.totals.metals_qq += richness_q(s.sites.metals[r]) * ex.eff()[r];
+    }
+    s.reactorsDirty = true;
+}
+
+mars::deposits::Field& Game::deposits() {
+    if (field.params().seed != s.rngSeed) {
+        mars::deposits::Params p = field.params();
+        p.seed = s.rngSeed;
+        field.reset(p);
+    }
+    return field;
+}
+
+// Uniform in [0, 1) from the top 24 bits, identical on every standard library
+// (std::uniform_real_distribution isn't).
+static double roll(std::mt19937& rng) {
+    return static_cast<double>(rng() >> 8) * (1.0 / 16777216.0);
+}
+
+void Game::maybeSpawnEvents() {
+    if (forecastMode) return; // forecasts run the deterministic baseline only
+
+    // Meteoroid (~0.15%/hr): halves one structure's health, picked uniformly
+    // over all instances; a second hit wrecks it.
+    if (roll(s.rng) < 0.0015) {
+        long long total = 0;
+        for (int c : s.count) total += c;
+        if (total > 0) {
+            long long pick = static_cast<long long>(roll(s.rng) * static_cast<double>(total));
+            for (size_t i = 0; i < s.count.size(); ++i) {
+                if (pick < s.count[i]) {
+                    const BuildingPool::Handle h = s.buildings[i].handleAt(static_cast<size_t>(pick));
+                    damage(BuildingId{static_cast<BuildingType>(i), h}, BuildingPool::kFull / 2);
+                    break;
+                }
+                pick -= s.count[i];
+            }
+        }
+    }
+    // Dust devil (~1%/hr): settles on every panel until cleaned. Touches
+    // each instance, but only in the hours it happens.
+    if (roll(s.rng) < 0.01) {
+        depositDust(BuildingType::Solar, BuildingPool::kFull / 50);
+    }
+    // Supply drop (~0.2%/hr): salvage metals.
+    if (roll(s.rng) < 0.0020) {
+        s.metals += 10;
+    }
+}
+
+void Game::simulateHour() {
+    // Reactors: a settled core sits on its closed-form fixed point and
+    // advance() returns at once, so the sum is only redone for an hour in
+    // which some core was in transient, the hour after, or after an edit.
+    if (s.reactorsDirty) {
+        double kw = 0.0;
+        bool stepped = false;
+        for (mars::reactor::Core& c : s.reactors) {
+            stepped = stepped || !c.settled;
+            kw += mars::reactor::advance(c, 1.0, reactor).avgKw;
+        }
+        s.reactorKw = kw;
+        s.reactorsDirty = stepped;
+    }
+
+    // Otherwise O(1) in the number of buildings: totals already hold
+    // SPEC × instances.
+    const double gen    = s.totals.generation_kw() + s.reactorKw;
+    const double demand = s.totals.demand_kw();
+    s.power_kw = gen - demand;
+    s.brownout = s.power_kw < 0.0;
+
+    // Extractors yield by site richness and their own efficiency; metals
+    // arrive in whole units, the remainder carried in s.ore.
+    s.water += s.totals.extracted_ice() * iceLPerH;
+    s.ore   += s.totals.extracted_metals() * metalsPerH;
+    const double whole = std::floor(s.ore);
+    s.metals += static_cast<int>(whole);
+    s.ore    -= whole;
+
+    // Crops, batched over every plot. Lamps run at a quarter during a
+    // brownout. A plot draws at most q·dt, so irrigation is scaled down to
+    // what the colony holds. Harvested kg count as food units.
+    if (s.plots.size() > 0) {
+        mars::greenhouse::Env env;
+        env.lightScale = s.brownout ? 0.25 : 1.0;
+        double wantL = 0.0;
+        for (double q : s.plots.irrigationLPerH) wantL += q * env.dtHours;
+        if (wantL > s.water) env.irrigationScale = std::max(0.0, s.water) / wantL;
+        const mars::greenhouse::PlotsSoA view{s.plots.biomassKg.data(), s.plots.waterL.data(),
+                                              s.plots.light.data(), s.plots.irrigationLPerH.data()};
+        s.lastGrowth = mars::greenhouse::step_batch(s.plots.size(), view, env, crops);
+        s.oxygen += s.lastGrowth.o2Kg;
+        s.water   = std::max(0.0, s.water - s.lastGrowth.waterL);  // integrator error can exceed q·dt
+        s.food   += s.lastGrowth.harvestKg;
+    } else {
+        s.lastGrowth = mars::greenhouse::Totals{};
+    }
+}
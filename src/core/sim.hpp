@@ -8,17 +8,51 @@ class Game {
 public:
     GameState s;
     bool forecastMode{false}; // you already use this knob
+    mars::greenhouse::Params crops;        // plot growth model
+    double irrigationLPerH{0.3};           // per new plot
+    int32_t siteSearchRadius{128};         // cells around (0, 0) tryBuild searches
+    double iceLPerH{2.0};                  // extractor on a site of richness 1
+    double metalsPerH{0.25};
+    mars::reactor::Params reactor;         // core dynamics and trip limits
 
-    // Single step: applies commands for this hour, spawns events, runs sim, ticks effects.
+    // Single step: applies commands for this hour, spawns events, runs sim.
     void step();
 
     // Public API—thin wrappers you already have
-    bool tryBuild(BuildingType t);
+    // Pays SPEC costs; false if unaffordable. `built` receives the new instance.
+    // Extractors go to the richest metals site within siteSearchRadius.
+    bool tryBuild(BuildingType t, BuildingId* built = nullptr);
+    // At map cell (x, y); only extractors care where they stand.
+    bool tryBuildAt(BuildingType t, int32_t x, int32_t y, BuildingId* built = nullptr);
+    bool destroy(BuildingType t);       // any one instance; false if none
+    bool destroy(BuildingId id);        // false for stale ids
     void submit(const Command& c) { orders.submit(c); }
 
+    // Instance state, Q16 (BuildingPool::kFull == 1.0). Each edit moves
+    // s.totals by the instance's change only.
+    bool damage(BuildingId id, int32_t amount);  // destroys at zero health
+    bool repair(BuildingId id);                  // metals ∝ missing health
+    bool clean(BuildingId id);
+    void depositDust(BuildingType t, int32_t amount);  // every instance of t
+
+    // Reactor controls; false for stale ids or other building types.
+    // Cooling follows the reactor's health, and a repair also resets a
+    // scram once the core has cooled below the trip temperature.
+    bool setReactorRods(BuildingId id, double insertion);  // 0 = full power
+    bool resetScram(BuildingId id);
+
+    // Rebuilds s.count and s.totals from the pools (after loading).
+    void recomputeTotals();
+
+    // Ice and metals on the map, reproducible from s.rngSeed.
+    mars::deposits::Field& deposits();
+
 private:
     CommandQueue orders;
+    mars::deposits::Field field;           // cache only; follows s.rngSeed
     void maybeSpawnEvents();  // move your existing logic here
     void simulateHour();      // “power, life support, greenhouse, etc.”
-    void tickEffects();       // post-step effects
+    void applyEffDelta(BuildingType t, int64_t delta, size_t row);
+    void syncHealth(BuildingId id);        // greenhouse lamps, reactor cooling (with dust)
+    mars::reactor::Core* core(BuildingId id);
 };
@@ -23,3 +23,26 @@ inline constexpr std::array<BuildingSpec, to_index(BuildingType::COUNT)> SPEC {{
 inline const BuildingSpec& getSpec(BuildingType t) {
     return SPEC[to_index(t)]; // avoids map lookups/at() throws
 }
+
+// Per-unit power terms in integer watts, derived from SPEC at compile time.
+// Running totals are kept in these units so adding and removing buildings
+// is exact: the totals after any build/destroy history equal SPEC × count.
+struct SpecWatts {
+    long long gen_w;     // power_out_kw when positive
+    long long load_w;    // -power_out_kw when negative
+    long long upkeep_w;
+};
+
+constexpr long long to_watts(double kw) {
+    return static_cast<long long>(kw * 1000.0 + (kw < 0.0 ? -0.5 : 0.5));
+}
+
+inline constexpr std::array<SpecWatts, to_index(BuildingType::COUNT)> SPEC_WATTS = [] {
+    std::array<SpecWatts, to_index(BuildingType::COUNT)> w{};
+    for (size_t i = 0; i < w.size(); ++i) {
+        const double out = SPEC[i].power_out_kw;
+        w[i] = SpecWatts{ out > 0.0 ? to_watts(out) : 0, out < 0.0 ? to_watts(-out) : 0,
+                          to_watts(SPEC[i].upkeep_kw) };
+    }
+    return w;
+}();
@@ -1,9 +1,97 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
 #include <array>
+#include <initializer_list>
 #include <vector>
 #include <random>
 #include "types.hpp"
+#include "buildings.hpp"
+#include "../systems/deposits.h"
+#include "../systems/greenhouse.h"
+#include "../systems/reactor.h"
+
+// SPEC × instance sums, kept in step with the pools by Game's build,
+// destroy and instance edits so the hourly step never walks buildings.
+// Generation is weighted by each instance's Q16 efficiency. Reactors are
+// left out: their output is the cores' state, summed into reactorKw.
+// Extractor yield is Σ eff × site richness, both Q16.
+struct BuildingTotals {
+    long long gen_wq{0};    // Σ gen_w × eff, watts × BuildingPool::kFull
+    long long load_w{0};
+    long long upkeep_w{0};
+    long long ice_qq{0};    // Σ eff × ice richness, × BuildingPool::kFull²
+    long long metals_qq{0};
+
+    double generation_kw() const {
+        return static_cast<double>(gen_wq) / (1000.0 * BuildingPool::kFull);
+    }
+    double demand_kw() const { return static_cast<double>(load_w + upkeep_w) / 1000.0; }
+    double extracted_ice() const { return static_cast<double>(ice_qq) / BuildingPool::kFull / BuildingPool::kFull; }
+    double extracted_metals() const {
+        return static_cast<double>(metals_qq) / BuildingPool::kFull / BuildingPool::kFull;
+    }
+};
+
+// Crop plots, kPerGreenhouse consecutive entries per Greenhouse pool row.
+// removeBlock() swaps the last block into the hole exactly as
+// BuildingPool::remove() swaps rows, so block r always belongs to row r.
+struct GreenhousePlots {
+    static constexpr size_t kPerGreenhouse = 4;
+    std::vector<double> biomassKg, waterL, light, irrigationLPerH;
+
+    size_t size() const { return biomassKg.size(); }
+
+    void addBlock(double seedKg, double water, double irrigation) {
+        for (size_t k = 0; k < kPerGreenhouse; ++k) {
+            biomassKg.push_back(seedKg);
+            waterL.push_back(water);
+            light.push_back(1.0);
+            irrigationLPerH.push_back(irrigation);
+        }
+    }
+
+    void removeBlock(size_t row) {
+        const size_t at = row * kPerGreenhouse, last = size() - kPerGreenhouse;
+        for (std::vector<double>* col : {&biomassKg, &waterL, &light, &irrigationLPerH}) {
+            if (at != last) std::copy(col->begin() + static_cast<long>(last), col->end(),
+                                      col->begin() + static_cast<long>(at));
+            col->resize(last);
+        }
+    }
+
+    void setLight(size_t row, double l) {
+        std::fill_n(light.begin() + static_cast<long>(row * kPerGreenhouse), kPerGreenhouse, l);
+    }
+};
+
+// Where each Extractor pool row stands, with the site's richness read once
+// at build time; swap-removed in step with the pool like GreenhousePlots.
+struct ExtractorSites {
+    std::vector<int32_t> x, y;
+    std::vector<float>   ice, metals;  // 0..1
+
+    size_t size() const { return x.size(); }
+
+    void add(int32_t sx, int32_t sy, float iceRichness, float metalsRichness) {
+        x.push_back(sx);
+        y.push_back(sy);
+        ice.push_back(iceRichness);
+        metals.push_back(metalsRichness);
+    }
+
+    void remove(size_t row) {
+        const size_t last = size() - 1;
+        x[row] = x[last];
+        y[row] = y[last];
+        ice[row] = ice[last];
+        metals[row] = metals[last];
+        x.pop_back();
+        y.pop_back();
+        ice.pop_back();
+        metals.pop_back();
+    }
+};
 
 struct GameState {
     // time
@@ -14,15 +102,30 @@ struct GameState {
     std::mt19937 rng{rngSeed};
 
     // resources
-    double power_kw{0.0};
+    double power_kw{0.0};   // net generation last hour (negative: deficit)
     double water{100.0};
     double oxygen{100.0};
     double food{100.0};
     int    credits{2000};
     int    metals{50};
 
-    // buildings inventory (counts per type)
+    // buildings: instances per type, with counts mirrored for quick reads
+    std::array<BuildingPool, to_index(BuildingType::COUNT)> buildings{};
     std::array<int, to_index(BuildingType::COUNT)> count{};
+    BuildingTotals totals;  // derived from `buildings`
+
+    GreenhousePlots plots;
+    ExtractorSites  sites;
+    double          ore{0.0};  // extracted metals not yet a whole unit
+
+    // One core per Reactor pool row, swap-removed with it.
+    std::vector<mars::reactor::Core> reactors;
+    double reactorKw{0.0};        // last hour's average electric output
+    bool   reactorsDirty{false};  // reactorKw needs redoing next hour
+
+    // last hour's power balance and crop output
+    bool brownout{false};
+    mars::greenhouse::Totals lastGrowth;
 
     void setSeed(uint32_t seed) { rngSeed = seed; rng.seed(seed); }
 };
@@ -0,0 +1,233 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Deterministic reductions for colony-wide aggregates.
+//
+// Floating-point addition is not associative, so a parallel sum whose shape
+// depends on the thread count gives a different answer per machine. Every
+// reduction here has a shape fixed by the element count alone:
+//   - tree_sum:  fixed kReduceChunk leaves, fixed kReduceLanes accumulators
+//                per leaf, then a pairwise tree over leaves. Fast, vectorizes.
+//   - exact_sum: integer superaccumulator; the result is independent of both
+//                thread count and element order.
+//   - int_sum:   wrap-around integer sum for fixed-point raw values.
+// Threads only decide *who* computes a leaf, never *how* leaves combine.
+
+namespace sim::det {
+
+inline constexpr size_t kReduceChunk = 4096;
+inline constexpr size_t kReduceLanes = 8;
+
+// Runs fn(firstChunk, lastChunk, worker) over [0, nChunks) split statically
+// across `threads` workers. threads <= 1 runs inline.
+template <class Fn>
+void for_each_chunk(size_t nChunks, unsigned threads, Fn&& fn) {
+    if (threads <= 1 || nChunks <= 1) {
+        fn(size_t{0}, nChunks, 0u);
+        return;
+    }
+    if (threads > nChunks) threads = static_cast<unsigned>(nChunks);
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    const size_t per = nChunks / threads, extra = nChunks % threads;
+    size_t first = 0;
+    for (unsigned t = 0; t < threads; ++t) {
+        const size_t last = first + per + (t < extra ? 1 : 0);
+        if (t + 1 == threads) fn(first, last, t);
+        else pool.emplace_back([&fn, first, last, t] { fn(first, last, t); });
+        first = last;
+    }
+    for (auto& th : pool) th.join();
+}
+
+inline size_t chunk_count(size_t n) { return (n + kReduceChunk - 1) / kReduceChunk; }
+
+// Combines partials pairwise in place: ((p0+p1)+(p2+p3))+... The shape only
+// depends on partials.size().
+inline double tree_combine(std::vector<double>& v) {
+    if (v.empty()) return 0.0;
+    size_t n = v.size();
+    while (n > 1) {
+        const size_t half = n / 2;
+        for (size_t i = 0; i < half; ++i) v[i] = v[2 * i] + v[2 * i + 1];
+        if (n & 1) v[half] = v[n - 1];
+        n = half + (n & 1);
+    }
+    return v[0];
+}
+
+// One leaf: element i always lands in lane i % kReduceLanes.
+template <class Proj>
+double leaf_sum_by(size_t first, size_t last, Proj&& proj) {
+    double acc[kReduceLanes] = {};
+    size_t i = first;
+    for (; i + kReduceLanes <= last; i += kReduceLanes) {
+        for (size_t k = 0; k < kReduceLanes; ++k) acc[k] += proj(i + k);
+    }
+    for (size_t k = 0; i < last; ++i, ++k) acc[k] += proj(i);
+    for (size_t w = kReduceLanes / 2; w > 0; w /= 2) {
+        for (size_t k = 0; k < w; ++k) acc[k] += acc[k + w];
+    }
+    return acc[0];
+}
+
+// Sum of proj(i) for i in [0, n).
+template <class Proj>
+double tree_sum_by(size_t n, Proj&& proj, unsigned threads = 1) {
+    std::vector<double> partial(chunk_count(n));
+    for_each_chunk(partial.size(), threads, [&](size_t c0, size_t c1, unsigned) {
+        for (size_t c = c0; c < c1; ++c) {
+            const size_t first = c * kReduceChunk;
+            const size_t last  = (first + kReduceChunk < n) ? first + kReduceChunk : n;
+            partial[c] = leaf_sum_by(first, last, proj);
+        }
+    });
+    return tree_combine(partial);
+}
+
+inline double tree_sum(const double* p, size_t n, unsigned threads = 1) {
+    return tree_sum_by(n, [p](size_t i) { return p[i]; }, threads);
+}
+
+// ---------- Exact mode ----------
+//
+// Every finite double is m * 2^e with a 53-bit integer m and e >= -1074, so
+// the exact sum fits a fixed-point integer with ~2100 bits. We keep it as 67
+// signed 32-bit "digits" in int64 limbs, which leaves room for 2^30 adds
+// between carry normalizations. Integer addition is associative, hence the
+// result does not depend on order, chunking or thread count. round() is
+// within 1 ulp of the exact sum.
+class SuperAccumulator {
+public:
+    static constexpr int kLimbs = 67;
+
+    void add(double x) {
+        uint64_t bits;
+        std::memcpy(&bits, &x, sizeof bits);
+        const bool     neg  = (bits >> 63) != 0;
+        const unsigned bexp = static_cast<unsigned>((bits >> 52) & 0x7FFu);
+        uint64_t       m    = bits & ((uint64_t{1} << 52) - 1);
+
+        if (bexp == 0x7FFu) {               // inf / nan
+            if (m != 0) nan_ = true;
+            else if (neg) negInf_ = true;
+            else posInf_ = true;
+            return;
+        }
+        unsigned pos = 0;                   // bit position of m's lsb above 2^-1074
+        if (bexp != 0) { m |= uint64_t{1} << 52; pos = bexp - 1; }
+        if (m == 0) return;
+
+        const unsigned i = pos / 32, o = pos % 32;
+        const int64_t d0 = static_cast<int64_t>(static_cast<uint32_t>(m << o));
+        const int64_t d1 = static_cast<int64_t>(static_cast<uint32_t>(o ? (m >> (32 - o)) : (m >> 32)));
+        const int64_t d2 = static_cast<int64_t>(o ? (m >> (64 - o)) : 0);
+        if (neg) { limb_[i] -= d0; limb_[i + 1] -= d1; limb_[i + 2] -= d2; }
+        else     { limb_[i] += d0; limb_[i + 1] += d1; limb_[i + 2] += d2; }
+
+        if (++pending_ == (uint32_t{1} << 30)) normalize();
+    }
+
+    void merge(const SuperAccumulator& o) {
+        SuperAccumulator b = o;
+        b.normalize();
+        normalize();
+        for (int k = 0; k < kLimbs; ++k) limb_[k] += b.limb_[k];
+        pending_ = 2; // each limb now holds up to two digits' worth
+        nan_ |= o.nan_; posInf_ |= o.posInf_; negInf_ |= o.negInf_;
+    }
+
+    double round() const {
+        if (nan_ || (posInf_ && negInf_)) return std::nan("");
+        if (posInf_) return HUGE_VAL;
+        if (negInf_) return -HUGE_VAL;
+
+        SuperAccumulator a = *this;
+        a.normalize();
+        const bool neg = a.limb_[kLimbs - 1] < 0;
+        if (neg) {
+            for (auto& l : a.limb_) l = -l;
+            a.normalize();
+        }
+        int t = kLimbs - 1;
+        while (t >= 0 && a.limb_[t] == 0) --t;
+        if (t < 0) return 0.0;
+
+        double r = 0.0;
+        const int lo = (t >= 2) ? t - 2 : 0;
+        for (int k = t; k >= lo; --k) r = r * 4294967296.0 + static_cast<double>(a.limb_[k]);
+        r = std::ldexp(r, 32 * lo - 1074);
+        return neg ? -r : r;
+    }
+
+private:
+    // Carry-propagate so limbs 0..kLimbs-2 are in [0, 2^32); the top limb
+    // carries the sign.
+    void normalize() {
+        for (int k = 0; k + 1 < kLimbs; ++k) {
+            const int64_t low = static_cast<int64_t>(static_cast<uint64_t>(limb_[k]) & 0xFFFFFFFFu);
+            limb_[k + 1] += (limb_[k] - low) / 4294967296LL; // exact
+            limb_[k] = low;
+        }
+        pending_ = 0;
+    }
+
+    int64_t  limb_[kLimbs] = {};
+    uint32_t pending_ = 0;
+    bool     nan_ = false, posInf_ = false, negInf_ = false;
+};
+
+template <class Proj>
+double exact_sum_by(size_t n, Proj&& proj, unsigned threads = 1) {
+    const size_t chunks = chunk_count(n);
+    std::vector<SuperAccumulator> part(threads > 1 ? threads : 1);
+    for_each_chunk(chunks, threads, [&](size_t c0, size_t c1, unsigned w) {
+        const size_t last = (c1 * kReduceChunk < n) ? c1 * kReduceChunk : n;
+        for (size_t i = c0 * kReduceChunk; i < last; ++i) part[w].add(proj(i));
+    });
+    for (size_t w = 1; w < part.size(); ++w) part[0].merge(part[w]);
+    return part[0].round();
+}
+
+inline double exact_sum(const double* p, size_t n, unsigned threads = 1) {
+    return exact_sum_by(n, [p](size_t i) { return p[i]; }, threads);
+}
+
+// ---------- Integer / fixed-point mode ----------
+//
+// Two's-complement wrap-around addition is associative, so any split gives
+// the same bits. Accumulates in uint64_t to keep overflow defined; the lane
+// loop vectorizes.
+template <class Proj>
+int64_t int_sum_by(size_t n, Proj&& proj, unsigned threads = 1) {
+    std::vector<uint64_t> part(threads > 1 ? threads : 1, 0);
+    for_each_chunk(chunk_count(n), threads, [&](size_t c0, size_t c1, unsigned w) {
+        const size_t last = (c1 * kReduceChunk < n) ? c1 * kReduceChunk : n;
+        uint64_t acc[kReduceLanes] = {};
+        size_t i = c0 * kReduceChunk;
+        for (; i + kReduceLanes <= last; i += kReduceLanes) {
+            for (size_t k = 0; k < kReduceLanes; ++k) acc[k] += static_cast<uint64_t>(proj(i + k));
+        }
+        for (; i < last; ++i) acc[0] += static_cast<uint64_t>(proj(i));
+        uint64_t s = 0;
+        for (uint64_t a : acc) s += a;
+        part[w] = s;
+    });
+    uint64_t s = 0;
+    for (uint64_t p : part) s += p;
+    return static_cast<int64_t>(s);
+}
+
+template <class T>
+int64_t int_sum(const T* p, size_t n, unsigned threads = 1) {
+    static_assert(std::is_integral<T>::value, "int_sum: integral element type required");
+    return int_sum_by(n, [p](size_t i) { return static_cast<int64_t>(p[i]); }, threads);
+}
+
+} // namespace sim::det
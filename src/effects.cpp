@@ -1,3 +1,3 @@
 // effects.cpp
 #include "effects.hpp"
-// Intentionally empty: current effect utilities are header-only.
+// Intentionally empty: EffectStore is header-only.
@@ -1,41 +1,171 @@
 #ifndef MARS_EFFECTS_HPP
 #define MARS_EFFECTS_HPP
 
-#include <algorithm>   // std::remove_if
-#include <cassert>     // assert (debug invariant)
-#include <iostream>    // std::cout
-#include <string>      // std::string
+#include <array>       // std::array
+#include <cstddef>     // std::size_t
+#include <cstdint>     // uint32_t, uint64_t
 
 namespace effects {
 
-// Erase–remove idiom to prune expired effects from a container.
-// Requirements for element type 'E':
-//   - E has a numeric 'hoursRemaining' field
-//   - E has a 'description' field (string-like)
-// Prints a "has cleared" line when not in forecast mode.
-template <typename EffectsContainer>
-void pruneExpiredEffects(EffectsContainer& effects, bool forecastMode)
-{
-    auto newEnd = std::remove_if(effects.begin(), effects.end(),
-        [&](const auto& e) {
-            if (e.hoursRemaining <= 0) {
-                if (!forecastMode) {
-                    std::cout << "[Weather] " << e.description << " has cleared.\n";
-                }
-                return true; // remove this expired effect
-            }
-            return false;
-        });
-
-    effects.erase(newEnd, effects.end());
-
-#ifndef NDEBUG
-    // Defensive check: nothing with non-positive remaining time should survive.
-    for (const auto& e : effects) {
-        assert(e.hoursRemaining > 0 && "pruneExpiredEffects: found non-positive hoursRemaining after pruning");
-    }
-#endif
-}
+// Handle to a live effect: slot index in the low 32 bits, slot generation in
+// the high 32. Generations start at 1, so 0 never names an effect.
+using EffectId = uint64_t;
+constexpr EffectId kNoEffect = 0;
+
+struct Effect {
+    long long   expiresAt   = 0;        // absolute hour; due once now >= expiresAt
+    int         kind        = 0;        // caller-defined tag
+    const char* description = nullptr;  // static text, e.g. for the clear message
+};
+
+// Timed effects keyed by absolute expiry hour. Nothing is decremented per
+// hour: an indexed binary min-heap orders effects by (expiresAt, insertion
+// order), so expire() costs one comparison when nothing is due and
+// O(log n) per effect that is.
+//
+// Storage is inline and fixed at `Capacity`, so the store never allocates
+// and copying it (the engine copies GameState for every forecast) is a
+// flat copy.
+template <std::size_t Capacity>
+class EffectStore {
+    static_assert(Capacity > 0 && Capacity < 0xFFFFFFFFu, "EffectStore capacity");
+
+public:
+    EffectStore() {
+        // Free stack pops from the back: hand out slot 0 first.
+        for (std::size_t i = 0; i < Capacity; ++i) free_[i] = static_cast<uint32_t>(Capacity - 1 - i);
+    }
+
+    // Returns kNoEffect when the store is full.
+    EffectId add(const Effect& e) {
+        if (size_ == Capacity) return kNoEffect;
+        const uint32_t slot = free_[Capacity - 1 - size_];
+        Slot& s = slots_[slot];
+        s.effect = e;
+        s.seq    = seq_++;
+        place(size_, slot);
+        siftUp(size_++);
+        return makeId(slot, s.gen);
+    }
+
+    // Removes a live effect without notifying. Returns false for stale ids.
+    bool cancel(EffectId id) {
+        if (!find(id)) return false;
+        remove(slots_[static_cast<uint32_t>(id)].pos);
+        return true;
+    }
+
+    const Effect* get(EffectId id) const {
+        const Slot* s = find(id);
+        return s ? &s->effect : nullptr;
+    }
+
+    bool        contains(EffectId id) const { return find(id) != nullptr; }
+    std::size_t size() const { return size_; }
+    bool        empty() const { return size_ == 0; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    // Earliest pending expiry, or `fallback` when nothing is pending.
+    long long nextExpiry(long long fallback) const {
+        return size_ ? slots_[heap_[0]].effect.expiresAt : fallback;
+    }
+
+    // Removes every effect with expiresAt <= now, in (expiresAt, insertion)
+    // order, calling notify(const Effect&) for each after it is removed, so
+    // the callback may add or cancel effects. Returns the number expired.
+    template <class Notify>
+    std::size_t expire(long long now, Notify&& notify) {
+        std::size_t n = 0;
+        while (size_ && slots_[heap_[0]].effect.expiresAt <= now) {
+            const Effect e = slots_[heap_[0]].effect;
+            remove(0);
+            ++n;
+            notify(e);
+        }
+        return n;
+    }
+
+    // Generations survive, so ids handed out before clear() stay stale.
+    void clear() {
+        while (size_) remove(size_ - 1);
+    }
+
+private:
+    struct Slot {
+        Effect   effect;
+        uint64_t seq = 0;
+        uint32_t gen = 1;
+        uint32_t pos = kFree;  // index into heap_
+    };
+    static constexpr uint32_t kFree = 0xFFFFFFFFu;
+
+    static EffectId makeId(uint32_t slot, uint32_t gen) {
+        return (static_cast<uint64_t>(gen) << 32) | slot;
+    }
+
+    const Slot* find(EffectId id) const {
+        const uint32_t slot = static_cast<uint32_t>(id);
+        if (slot >= Capacity) return nullptr;
+        const Slot& s = slots_[slot];
+        return s.pos != kFree && s.gen == static_cast<uint32_t>(id >> 32) ? &s : nullptr;
+    }
+
+    bool before(uint32_t a, uint32_t b) const {
+        const Slot& x = slots_[a];
+        const Slot& y = slots_[b];
+        return x.effect.expiresAt != y.effect.expiresAt ? x.effect.expiresAt < y.effect.expiresAt
+                                                        : x.seq < y.seq;
+    }
+
+    void place(std::size_t i, uint32_t slot) {
+        heap_[i] = slot;
+        slots_[slot].pos = static_cast<uint32_t>(i);
+    }
+
+    void siftUp(std::size_t i) {
+        const uint32_t slot = heap_[i];
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / 2;
+            if (!before(slot, heap_[parent])) break;
+            place(i, heap_[parent]);
+            i = parent;
+        }
+        place(i, slot);
+    }
+
+    void siftDown(std::size_t i) {
+        const uint32_t slot = heap_[i];
+        for (;;) {
+            std::size_t child = 2 * i + 1;
+            if (child >= size_) break;
+            if (child + 1 < size_ && before(heap_[child + 1], heap_[child])) ++child;
+            if (!before(heap_[child], slot)) break;
+            place(i, heap_[child]);
+            i = child;
+        }
+        place(i, slot);
+    }
+
+    // Takes heap_[i] out, retires its slot and restores the heap order.
+    void remove(std::size_t i) {
+        Slot& s = slots_[heap_[i]];
+        free_[Capacity - size_] = heap_[i];
+        s.pos = kFree;
+        s.effect = Effect{};
+        if (++s.gen == 0) s.gen = 1;
+        if (i != --size_) {
+            place(i, heap_[size_]);
+            if (i > 0 && before(heap_[i], heap_[(i - 1) / 2])) siftUp(i);
+            else siftDown(i);
+        }
+    }
+
+    std::array<Slot, Capacity>     slots_{};
+    std::array<uint32_t, Capacity> heap_{};
+    std::array<uint32_t, Capacity> free_{};  // free_[0 .. Capacity - size_) are free
+    std::size_t                    size_ = 0;
+    uint64_t                       seq_  = 0;
+};
 
 } // namespace effects
 
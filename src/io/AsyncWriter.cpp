@@ -0,0 +1,558 @@
+// AsyncWriter.cpp
+#include "AsyncWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && defined(__has_include)
+  #if __has_include(<linux/io_uring.h>)
+    #define MARS_HAVE_IO_URING 1
+  #endif
+#endif
+
+#if defined(_WIN32)
+  #include <fcntl.h>
+  #include <io.h>
+  #include <sys/stat.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+#ifdef MARS_HAVE_IO_URING
+  #include <cerrno>
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <sys/uio.h>
+#endif
+
+namespace mars::io {
+
+static uint64_t now_ns() {
+    using clock = std::chrono::steady_clock;
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count());
+}
+
+// ---------- Platform file helpers ----------
+
+static int open_trunc(const std::string& path) {
+#if defined(_WIN32)
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+}
+
+static void close_fd(int fd) {
+#if defined(_WIN32)
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+// Positional write; returns bytes written or -1.
+static long long write_at(int fd, const void* p, size_t n, uint64_t off) {
+#if defined(_WIN32)
+    // No pwrite on the CRT: serialize seek+write.
+    static std::mutex m;
+    std::lock_guard<std::mutex> lk(m);
+    if (::_lseeki64(fd, static_cast<long long>(off), SEEK_SET) < 0) return -1;
+    return ::_write(fd, p, static_cast<unsigned>(n));
+#else
+    return static_cast<long long>(::pwrite(fd, p, n, static_cast<off_t>(off)));
+#endif
+}
+
+// ---------- Shared state ----------
+
+struct Job {
+    int      file   = -1;
+    int      fd     = -1;
+    uint64_t offset = 0;
+    uint32_t len    = 0;
+    uint32_t done   = 0;   // bytes already written (short writes resubmit)
+    uint64_t t0     = 0;
+};
+
+struct Completion {
+    unsigned  buf;
+    long long res;
+    uint64_t  t_done;   // when the backend saw the write finish
+};
+
+struct BackendBase {
+    virtual ~BackendBase() = default;
+    virtual bool init() = 0;
+    virtual void queue(unsigned buf) = 0;     // stage a write of jobs[buf]
+    virtual void submit() = 0;                // hand staged writes to the kernel/workers
+    virtual void reap(bool wait, std::vector<Completion>& out) = 0;
+};
+
+struct AsyncWriter::Impl {
+    struct File {
+        int      fd       = -1;
+        uint64_t offset   = 0;   // next byte to assign
+        int      cur      = -1;  // buffer being filled
+        uint32_t fill     = 0;
+        unsigned inflight = 0;
+        bool     failed   = false;
+        bool     closing  = false;  // close_async(): close at inflight == 0
+    };
+
+    Options                          opt;
+    Backend                          used = Backend::ThreadPool;
+    std::unique_ptr<unsigned char[]> storage;
+    std::vector<Job>                 jobs;
+    std::vector<unsigned>            freeBufs;
+    std::vector<File>                files;
+    std::unique_ptr<BackendBase>     be;
+    std::vector<Completion>          scratch;
+    mars::LatencyHistogram           lat;
+    mars::LatencyMetric&             writeLat = mars::latency_metric("io.write");
+    mars::LatencyMetric&             flushLat = mars::latency_metric("io.flush");
+    mars::LatencyMetric&             drainLat = mars::latency_metric("io.drain");
+    uint64_t                         bytes    = 0;
+    uint64_t                         waits    = 0;
+    unsigned                         inflight = 0;
+    unsigned                         staged   = 0;
+
+    unsigned char* buf(unsigned i) { return storage.get() + static_cast<size_t>(i) * opt.buffer_bytes; }
+
+    void handle(const Completion& c) {
+        Job& j = jobs[c.buf];
+        File& f = files[static_cast<size_t>(j.file)];
+        if (c.res > 0 && j.done + static_cast<uint32_t>(c.res) < j.len) {
+            j.done += static_cast<uint32_t>(c.res);  // short write: send the rest
+            be->queue(c.buf);
+            be->submit();
+            return;
+        }
+        if (c.res <= 0 || j.done + static_cast<uint32_t>(c.res) != j.len) f.failed = true;
+        else bytes += j.len;
+        const uint64_t ns = c.t_done - j.t0;
+        lat.record(ns);
+        writeLat.record(ns);
+        --f.inflight;
+        --inflight;
+        freeBufs.push_back(c.buf);
+        if (f.closing && f.inflight == 0) finishClose(f);
+    }
+
+    void finishClose(File& f) {
+        if (f.cur >= 0) { freeBufs.push_back(static_cast<unsigned>(f.cur)); f.cur = -1; }
+        close_fd(f.fd);
+        f.fd = -1;
+        f.closing = false;
+    }
+
+    void pump(bool wait) {
+        scratch.clear();
+        be->reap(wait && inflight > 0, scratch);
+        for (const auto& c : scratch) handle(c);
+    }
+
+    void kick() {
+        if (staged) { be->submit(); staged = 0; }
+    }
+
+    // With nothing in flight every buffer is some file's partly filled
+    // `cur`, and waiting would never end: write out the fullest one early.
+    void spill() {
+        File* fullest = nullptr;
+        size_t id = 0;
+        for (size_t i = 0; i < files.size(); ++i) {
+            File& f = files[i];
+            if (f.cur >= 0 && (!fullest || f.fill > fullest->fill)) { fullest = &f; id = i; }
+        }
+        if (!fullest) return;
+        const unsigned b = static_cast<unsigned>(fullest->cur);
+        const uint32_t len = fullest->fill;
+        fullest->cur = -1;
+        if (len == 0) { freeBufs.push_back(b); return; }
+        enqueue(static_cast<int>(id), b, len);
+    }
+
+    unsigned acquire() {
+        if (freeBufs.empty()) pump(false);
+        while (freeBufs.empty()) {
+            ++waits;
+            if (inflight == 0) spill();
+            kick();
+            pump(true);
+        }
+        const unsigned b = freeBufs.back();
+        freeBufs.pop_back();
+        return b;
+    }
+
+    void enqueue(int file, unsigned b, uint32_t len) {
+        File& f = files[static_cast<size_t>(file)];
+        Job& j = jobs[b];
+        j.file = file; j.fd = f.fd; j.offset = f.offset; j.len = len; j.done = 0; j.t0 = now_ns();
+        f.offset += len;
+        ++f.inflight;
+        ++inflight;
+        be->queue(b);
+        if (++staged >= opt.batch) kick();
+    }
+};
+
+// ---------- Thread-pool backend ----------
+
+namespace {
+
+class ThreadPoolBackend final : public BackendBase {
+public:
+    explicit ThreadPoolBackend(AsyncWriter::Impl& w) : w_(w) {}
+
+    ~ThreadPoolBackend() override {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+        }
+        cvWork_.notify_all();
+        for (auto& t : pool_) t.join();
+    }
+
+    bool init() override {
+        const unsigned n = std::max(1u, w_.opt.threads);
+        for (unsigned i = 0; i < n; ++i) pool_.emplace_back([this] { run(); });
+        return true;
+    }
+
+    void queue(unsigned buf) override { staged_.push_back(buf); }
+
+    void submit() override {
+        if (staged_.empty()) return;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            for (unsigned b : staged_) work_.push_back(b);
+        }
+        staged_.clear();
+        cvWork_.notify_all();
+    }
+
+    void reap(bool wait, std::vector<Completion>& out) override {
+        std::unique_lock<std::mutex> lk(m_);
+        if (wait) cvDone_.wait(lk, [this] { return !done_.empty(); });
+        out.insert(out.end(), done_.begin(), done_.end());
+        done_.clear();
+    }
+
+private:
+    void run() {
+        for (;;) {
+            unsigned b;
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                cvWork_.wait(lk, [this] { return stop_ || !work_.empty(); });
+                if (work_.empty()) return;
+                b = work_.front();
+                work_.pop_front();
+            }
+            const Job& j = w_.jobs[b];
+            const long long r = write_at(j.fd, w_.buf(b) + j.done, j.len - j.done, j.offset + j.done);
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                done_.push_back(Completion{b, r, now_ns()});
+            }
+            cvDone_.notify_one();
+        }
+    }
+
+    AsyncWriter::Impl&       w_;
+    std::vector<unsigned>    staged_;
+    std::mutex               m_;
+    std::condition_variable  cvWork_, cvDone_;
+    std::deque<unsigned>     work_;
+    std::vector<Completion>  done_;
+    std::vector<std::thread> pool_;
+    bool                     stop_ = false;
+};
+
+// ---------- io_uring backend ----------
+
+#ifdef MARS_HAVE_IO_URING
+
+class UringBackend final : public BackendBase {
+public:
+    explicit UringBackend(AsyncWriter::Impl& w) : w_(w) {}
+
+    ~UringBackend() override {
+        if (sqes_) ::munmap(sqes_, sqesLen_);
+        if (cqPtr_ && cqPtr_ != sqPtr_) ::munmap(cqPtr_, cqLen_);
+        if (sqPtr_) ::munmap(sqPtr_, sqLen_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    bool init() override {
+        unsigned entries = 1;
+        while (entries < w_.opt.buffers) entries <<= 1;   // never more writes in flight than buffers
+
+        io_uring_params p;
+        std::memset(&p, 0, sizeof p);
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+        if (fd_ < 0) return false;
+
+        sqLen_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqLen_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sqLen_ = cqLen_ = std::max(sqLen_, cqLen_);
+
+        sqPtr_ = ::mmap(nullptr, sqLen_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (sqPtr_ == MAP_FAILED) { sqPtr_ = nullptr; return false; }
+        cqPtr_ = single ? sqPtr_
+                        : ::mmap(nullptr, cqLen_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        if (cqPtr_ == MAP_FAILED) { cqPtr_ = nullptr; return false; }
+        sqesLen_ = p.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqesLen_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<unsigned char*>(sqPtr_);
+        auto* cq = static_cast<unsigned char*>(cqPtr_);
+        sqHead_  = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sqTail_  = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sqMask_  = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        cqHead_  = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cqTail_  = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cqMask_  = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_    = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+        // Registered buffers skip the per-write page pinning. Needs enough
+        // RLIMIT_MEMLOCK; plain WRITE is fine when it is refused.
+        std::vector<iovec> iov(w_.opt.buffers);
+        for (unsigned i = 0; i < w_.opt.buffers; ++i) {
+            iov[i].iov_base = w_.buf(i);
+            iov[i].iov_len  = w_.opt.buffer_bytes;
+        }
+        fixed_ = ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS,
+                           iov.data(), static_cast<unsigned>(iov.size())) == 0;
+        return true;
+    }
+
+    void queue(unsigned buf) override {
+        const unsigned tail = *sqTail_;
+        const unsigned idx  = tail & sqMask_;
+        io_uring_sqe& sqe = sqes_[idx];
+        std::memset(&sqe, 0, sizeof sqe);
+        const Job& j = w_.jobs[buf];
+        sqe.opcode    = fixed_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe.fd        = j.fd;
+        sqe.off       = j.offset + j.done;
+        sqe.addr      = reinterpret_cast<uint64_t>(w_.buf(buf) + j.done);
+        sqe.len       = j.len - j.done;
+        sqe.user_data = buf;
+        if (fixed_) sqe.buf_index = static_cast<uint16_t>(buf);
+        sqArray_[idx] = idx;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+        ++toSubmit_;
+    }
+
+    void submit() override {
+        while (toSubmit_ > 0) {
+            const long r = ::syscall(__NR_io_uring_enter, fd_, toSubmit_, 0, 0, nullptr, 0);
+            if (r > 0) {
+                toSubmit_ -= static_cast<unsigned>(r);
+                inKernel_ += static_cast<unsigned>(r);
+                continue;
+            }
+            if (r < 0 && errno == EINTR) continue;
+            // Completion queue full: the next reap() frees it and retries.
+            if (r < 0 && (errno == EBUSY || errno == EAGAIN) && inKernel_ > 0) return;
+            failStaged(r < 0 ? -errno : -EIO);
+            return;
+        }
+    }
+
+    void reap(bool wait, std::vector<Completion>& out) override {
+        submit();
+        out.insert(out.end(), failed_.begin(), failed_.end());
+        const bool any = !failed_.empty();
+        failed_.clear();
+        unsigned head = *cqHead_;
+        if (wait && !any && inKernel_ > 0 && head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+            ::syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        }
+        const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& c = cqes_[head & cqMask_];
+            out.push_back(Completion{static_cast<unsigned>(c.user_data), static_cast<long long>(c.res), now_ns()});
+            --inKernel_;
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    // The ring refused the staged entries: take them back off the queue and
+    // complete each with `res`, so the writer frees their buffers and marks
+    // the files failed instead of waiting on writes that never started.
+    void failStaged(long long res) {
+        const unsigned tail = *sqTail_;
+        for (unsigned i = tail - toSubmit_; i != tail; ++i) {
+            failed_.push_back(Completion{static_cast<unsigned>(sqes_[i & sqMask_].user_data), res, now_ns()});
+        }
+        __atomic_store_n(sqTail_, tail - toSubmit_, __ATOMIC_RELEASE);
+        toSubmit_ = 0;
+    }
+
+    AsyncWriter::Impl& w_;
+    int           fd_      = -1;
+    void*         sqPtr_   = nullptr;
+    void*         cqPtr_   = nullptr;
+    size_t        sqLen_   = 0, cqLen_ = 0, sqesLen_ = 0;
+    io_uring_sqe* sqes_    = nullptr;
+    io_uring_cqe* cqes_    = nullptr;
+    unsigned*     sqHead_  = nullptr;
+    unsigned*     sqTail_  = nullptr;
+    unsigned*     sqArray_ = nullptr;
+    unsigned*     cqHead_  = nullptr;
+    unsigned*     cqTail_  = nullptr;
+    unsigned      sqMask_  = 0, cqMask_ = 0;
+    unsigned      toSubmit_ = 0;    // queued in the SQ ring, not yet entered
+    unsigned      inKernel_ = 0;    // entered, completion not yet reaped
+    std::vector<Completion> failed_;
+    bool          fixed_   = false;
+};
+
+#endif // MARS_HAVE_IO_URING
+
+} // namespace
+
+// ---------- AsyncWriter ----------
+
+AsyncWriter::AsyncWriter() : AsyncWriter(Options{}) {}
+
+AsyncWriter::AsyncWriter(const Options& opt) : impl_(std::make_unique<Impl>()) {
+    Impl& w = *impl_;
+    w.opt = opt;
+    if (w.opt.buffers == 0) w.opt.buffers = 1;
+    if (w.opt.buffer_bytes == 0) w.opt.buffer_bytes = 4096;
+    if (w.opt.batch == 0) w.opt.batch = 1;
+    w.storage.reset(new unsigned char[w.opt.buffers * w.opt.buffer_bytes]);
+    w.jobs.resize(w.opt.buffers);
+    for (unsigned i = w.opt.buffers; i > 0; --i) w.freeBufs.push_back(i - 1);
+    w.scratch.reserve(w.opt.buffers);
+
+#ifdef MARS_HAVE_IO_URING
+    if (opt.backend != Backend::ThreadPool) {
+        w.be = std::make_unique<UringBackend>(w);
+        if (w.be->init()) w.used = Backend::IoUring;
+        else w.be.reset();
+    }
+#endif
+    if (!w.be) {
+        w.be = std::make_unique<ThreadPoolBackend>(w);
+        w.be->init();
+        w.used = Backend::ThreadPool;
+    }
+}
+
+AsyncWriter::~AsyncWriter() {
+    drain();
+    for (int i = 0; i < static_cast<int>(impl_->files.size()); ++i) close(i);
+}
+
+int AsyncWriter::open(const std::string& path) {
+    const int fd = open_trunc(path);
+    if (fd < 0) return -1;
+    Impl::File f;
+    f.fd = fd;
+    auto& files = impl_->files;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (files[i].fd < 0) { files[i] = f; return static_cast<int>(i); }
+    }
+    files.push_back(f);
+    return static_cast<int>(files.size() - 1);
+}
+
+bool AsyncWriter::append(int file, const void* data, size_t n) {
+    Impl& w = *impl_;
+    if (file < 0 || static_cast<size_t>(file) >= w.files.size()) return false;
+    // A file passed to close_async() takes no more data, even while its
+    // last writes are still in flight.
+    if (w.files[static_cast<size_t>(file)].fd < 0 || w.files[static_cast<size_t>(file)].closing) return false;
+    const auto* p = static_cast<const unsigned char*>(data);
+    while (n > 0) {
+        Impl::File& g = w.files[static_cast<size_t>(file)];
+        if (g.cur < 0) { g.cur = static_cast<int>(w.acquire()); g.fill = 0; }
+        const size_t room = w.opt.buffer_bytes - g.fill;
+        const size_t take = std::min(room, n);
+        std::memcpy(w.buf(static_cast<unsigned>(g.cur)) + g.fill, p, take);
+        g.fill += static_cast<uint32_t>(take);
+        p += take;
+        n -= take;
+        if (g.fill == w.opt.buffer_bytes) {
+            const unsigned b = static_cast<unsigned>(g.cur);
+            g.cur = -1;
+            w.enqueue(file, b, g.fill);
+        }
+    }
+    return !w.files[static_cast<size_t>(file)].failed;
+}
+
+void AsyncWriter::flush(int file) {
+    Impl& w = *impl_;
+    if (file < 0 || static_cast<size_t>(file) >= w.files.size()) return;
+    mars::ScopedLatency timed(w.flushLat);
+    w.pump(false);   // reap what finished since the last call
+    Impl::File& f = w.files[static_cast<size_t>(file)];
+    if (f.cur >= 0 && f.fill > 0) {
+        const unsigned b = static_cast<unsigned>(f.cur);
+        const uint32_t len = f.fill;
+        f.cur = -1;
+        w.enqueue(file, b, len);
+    }
+    w.kick();
+}
+
+bool AsyncWriter::drain() {
+    Impl& w = *impl_;
+    mars::ScopedLatency timed(w.drainLat);
+    for (int i = 0; i < static_cast<int>(w.files.size()); ++i) {
+        if (w.files[static_cast<size_t>(i)].fd >= 0) flush(i);
+    }
+    w.kick();
+    while (w.inflight > 0) w.pump(true);
+    bool ok = true;
+    for (const auto& f : w.files) ok = ok && !f.failed;
+    return ok;
+}
+
+bool AsyncWriter::close(int file) {
+    Impl& w = *impl_;
+    if (file < 0 || static_cast<size_t>(file) >= w.files.size()) return false;
+    if (w.files[static_cast<size_t>(file)].fd < 0) return !w.files[static_cast<size_t>(file)].failed;
+    flush(file);
+    while (w.files[static_cast<size_t>(file)].inflight > 0) w.pump(true);
+    Impl::File& f = w.files[static_cast<size_t>(file)];
+    const bool ok = !f.failed;
+    w.finishClose(f);
+    return ok;
+}
+
+void AsyncWriter::close_async(int file) {
+    Impl& w = *impl_;
+    if (file < 0 || static_cast<size_t>(file) >= w.files.size()) return;
+    if (w.files[static_cast<size_t>(file)].fd < 0) return;
+    flush(file);
+    Impl::File& f = w.files[static_cast<size_t>(file)];
+    if (f.inflight == 0) w.finishClose(f);
+    else f.closing = true;
+}
+
+AsyncWriter::Backend          AsyncWriter::backend() const       { return impl_->used; }
+const mars::LatencyHistogram& AsyncWriter::latency() const       { return impl_->lat; }
+uint64_t                      AsyncWriter::bytes_written() const { return impl_->bytes; }
+uint64_t                      AsyncWriter::buffer_waits() const  { return impl_->waits; }
+
+} // namespace mars::io
@@ -0,0 +1,73 @@
+// AsyncWriter.h
+#pragma once
+#include "../../include/mars/latency.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mars::io {
+
+// Append-only writer for recordings, checkpoints and telemetry.
+//
+// append() copies into a pooled, fixed-size buffer; full buffers are queued
+// and submitted in batches, and a buffer returns to the pool when its write
+// completes. The sim thread only blocks when every buffer is in flight; when
+// open files hold every buffer partly filled, the fullest is written early.
+//
+// Backends:
+//   IoUring     Linux io_uring via raw syscalls; buffers are registered with
+//               the ring (WRITE_FIXED) when the memlock limit allows.
+//   ThreadPool  worker threads doing positional writes; used everywhere else
+//               and whenever the ring cannot be set up.
+//
+// Not thread-safe: one owner thread per writer.
+class AsyncWriter {
+public:
+    enum class Backend { Auto, IoUring, ThreadPool };
+
+    struct Options {
+        Backend  backend      = Backend::Auto;
+        size_t   buffer_bytes = 64 * 1024;
+        unsigned buffers      = 16;
+        unsigned batch        = 8;    // submit once this many writes are queued
+        unsigned threads      = 2;    // ThreadPool backend only
+    };
+
+    AsyncWriter();
+    explicit AsyncWriter(const Options& opt);
+    ~AsyncWriter();   // drains and closes everything
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    // Creates/truncates `path`. Returns a file id, or -1 on failure.
+    int  open(const std::string& path);
+    bool append(int file, const void* data, size_t n);
+    bool append(int file, const std::string& s) { return append(file, s.data(), s.size()); }
+    // Queues the file's partially filled buffer and submits pending writes.
+    void flush(int file);
+    // Flushes every file and waits for all writes. False if any write failed.
+    bool drain();
+    // flush + wait for the file's writes + close. False if any write failed.
+    bool close(int file);
+    // flush, then close once the file's writes complete, without waiting.
+    // The id is invalid after this call (append() fails) and may be reused
+    // by open().
+    void close_async(int file);
+
+    Backend  backend() const;        // the one actually in use
+    // Submit-to-completion time of this writer's writes. Kept apart from tick
+    // timing so a slow disk shows up here and not as tick jitter. io_uring
+    // completions are stamped when reaped, so a writer that is rarely touched
+    // overstates its latency.
+    const mars::LatencyHistogram& latency() const;
+    uint64_t bytes_written() const;
+    uint64_t buffer_waits() const;   // appends that had to wait for a buffer
+
+    struct Impl;
+private:
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace mars::io
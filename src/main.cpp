@@ -1,7 +1,17 @@
 #include "sim/SimClock.h"
 #include "sim/Simulation.h"
 #include "sim/Recorder.h"
+#include "sim/Pipeline.h"
+#include "sim/FramePacer.h"
+#include "io/AsyncWriter.h"
 #include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
 
 static int64_t now_us() {
     using clock = std::chrono::steady_clock;
@@ -10,7 +20,44 @@ static int64_t now_us() {
     return std::chrono::duration_cast<std::chrono::microseconds>(dt).count();
 }
 
-int main() {
+struct Options {
+    unsigned  pipeline_depth  = 0;      // 0 = record/verify inline on the sim thread
+    bool      verify          = false;  // write per-tick checksums to checksums.txt
+    double    speed           = 1.0;
+    LagPolicy lag             = LagPolicy::Drop;
+    uint64_t  frame_budget_us = 50'000; // wall time per frame spent stepping
+    uint64_t  spin_us         = 200;    // pacer busy-waits this close to a deadline
+    uint64_t  latency_dump_s  = 0;      // append latency percentiles to latency.txt every N s
+};
+
+static Options parse_args(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc) {
+            o.pipeline_depth = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--verify") == 0) {
+            o.verify = true;
+        } else if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            o.speed = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--lag") == 0 && i + 1 < argc) {
+            o.lag = std::strcmp(argv[++i], "slow") == 0 ? LagPolicy::SlowDown : LagPolicy::Drop;
+        } else if (std::strcmp(argv[i], "--frame-budget") == 0 && i + 1 < argc) {
+            o.frame_budget_us = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--spin-us") == 0 && i + 1 < argc) {
+            o.spin_us = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--latency-dump") == 0 && i + 1 < argc) {
+            o.latency_dump_s = std::strtoull(argv[++i], nullptr, 10);
+        }
+    }
+#ifdef MARS_VERIFY
+    o.verify = true;
+#endif
+    return o;
+}
+
+int main(int argc, char** argv) {
+    const Options opt = parse_args(argc, argv);
+
     sim::Simulation simulation(/*seed=*/12345);
     sim::Recorder   recorder;
 
@@ -19,28 +66,114 @@ int main() {
     w.colonists.push_back({1, 20000, 0, 0, 293'000}); // 293 K
     w.habitats.push_back({1, 50000, 101'325'000, 15'000});
 
-    SimClock clock;
-    int64_t last = now_us();
+    // Recording, checksum trace and checkpoints all go through one writer so
+    // the sim thread never waits on the disk.
+    mars::io::AsyncWriter writer;
+    const int trace = opt.verify ? writer.open("checksums.txt") : -1;
+
+    // The pipeline worker owns `writer` while it runs, so periodic latency
+    // dumps from this thread get a writer of their own.
+    mars::io::AsyncWriter::Options stats_opt;
+    stats_opt.buffers = 2;
+    stats_opt.threads = 1;
+    mars::io::AsyncWriter stats_writer(stats_opt);
+    const int stats = opt.latency_dump_s ? stats_writer.open("latency.txt") : -1;
+
+    // Per-tick bookkeeping. Inline mode calls this on the sim thread; the
+    // pipelined mode calls it on a worker with a snapshot of the world.
+    auto bookkeeping = [&](const sim::World& snap, uint64_t tick, const sim::Input& in) {
+        recorder.push(tick, in);
+        if (trace >= 0) {
+            char line[48];
+            const int n = std::snprintf(line, sizeof line, "%" PRIu64 " %016" PRIX64 "\n",
+                                        snap.tick, snap.checksum());
+            writer.append(trace, line, static_cast<size_t>(n));
+        }
+    };
+
+    std::unique_ptr<sim::TickPipeline> pipeline;
+    if (opt.pipeline_depth > 0) {
+        pipeline = std::make_unique<sim::TickPipeline>(opt.pipeline_depth, bookkeeping);
+    }
+
+    SimClock clock(static_cast<uint64_t>(mars::kTickMicros));   // kSimHz, like the system periods
+    clock.set_speed(opt.speed);
+    clock.set_lag_policy(opt.lag);
+    clock.set_frame_budget_us(opt.frame_budget_us);
+    sim::FramePacer pacer(opt.spin_us);
+    const std::clock_t cpu0 = std::clock();
+    const int64_t wall0 = now_us();
+    int64_t last = wall0;
+    int64_t next_dump = wall0 + static_cast<int64_t>(opt.latency_dump_s) * 1'000'000;
 
     while (true) {
         int64_t t = now_us();
-        clock.advance_by_frame_us(t - last);
+        clock.advance_by_frame_us(static_cast<uint64_t>(t - last));
         last = t;
 
         while (clock.step_ready()) {
             sim::Input in{};
             // TODO: read UI/CLI input deterministically into 'in'
-            recorder.push(w.tick, in);
+            const uint64_t tick = w.tick;
+            const int64_t t0 = now_us();
             simulation.tick(in);
-            clock.consume_step();
+            if (pipeline) pipeline->submit(w, tick, in);
+            else          bookkeeping(w, tick, in);
+            clock.consume_step(static_cast<uint64_t>(now_us() - t0));
         }
 
         // TODO: render using clock.alpha() if you interpolate between last/cur states
 
+        if (stats >= 0 && t >= next_dump) {
+            char head[48];
+            const int n = std::snprintf(head, sizeof head, "# t=%.3fs\n", static_cast<double>(t - wall0) / 1e6);
+            stats_writer.append(stats, head, static_cast<size_t>(n));
+            stats_writer.append(stats, mars::latency_registry().report());
+            stats_writer.flush(stats);
+            next_dump += static_cast<int64_t>(opt.latency_dump_s) * 1'000'000;
+        }
+
         // Temporary exit condition for example builds
         if (w.tick > 2000) break;
+
+        // Sleep until the next step is due instead of polling the clock. The
+        // pacer keeps an absolute schedule, so wake-up lateness doesn't add up.
+        pacer.wait_next(std::chrono::microseconds(clock.wall_us_per_step()));
     }
 
-    recorder.save("replay.bin");
+    if (pipeline) pipeline->finish(); // recorder is ours again after this
+    if (trace >= 0) writer.close(trace);
+    recorder.save(writer, "replay.bin");
+    writer.drain();
+
+    const SimClockStats& cs = clock.stats();
+    std::fprintf(stderr, "clock: speed %.3fx of %.3fx requested, tick cost %" PRIu64 "us, budget %u steps/frame, "
+                 "backlog %" PRIu64 " ticks, dropped %" PRIu64 "us over %" PRIu64 " frames\n",
+                 cs.effective_speed_q16 / 65536.0, cs.requested_speed_q16 / 65536.0, cs.tick_cost_us,
+                 cs.step_budget, cs.backlog_ticks, cs.dropped_us, cs.frames);
+
+    const sim::PacerStats& ps = pacer.stats();
+    const double wall_s = static_cast<double>(now_us() - wall0) / 1e6;
+    const double cpu_s  = static_cast<double>(std::clock() - cpu0) / CLOCKS_PER_SEC;
+    std::fprintf(stderr, "pacer: %" PRIu64 " waits, slept %.3fs spun %.3fs, late p50 %" PRIu64 "us p99 %" PRIu64
+                 "us max %" PRIu64 "us, %" PRIu64 " restarts, cpu %.1f%% of wall\n",
+                 ps.waits, static_cast<double>(ps.slept_ns) / 1e9, static_cast<double>(ps.spun_ns) / 1e9,
+                 ps.late_quantile_us(0.50), ps.late_quantile_us(0.99), ps.late_max_ns / 1000, ps.restarts,
+                 wall_s > 0 ? 100.0 * cpu_s / wall_s : 0.0);
+
+    const mars::LatencyHistogram& io = writer.latency();
+    std::fprintf(stderr, "io: %" PRIu64 " writes, %" PRIu64 " bytes, p50 %" PRIu64
+                 "us p99 %" PRIu64 "us p99.9 %" PRIu64 "us max %" PRIu64 "us, %" PRIu64 " buffer waits\n",
+                 io.count(), writer.bytes_written(),
+                 io.quantile(0.50) / 1000, io.quantile(0.99) / 1000,
+                 io.quantile(0.999) / 1000, io.max() / 1000, writer.buffer_waits());
+
+    const std::string lat = mars::latency_registry().report();
+    std::fputs(lat.c_str(), stderr);
+    if (stats >= 0) {
+        stats_writer.append(stats, "# exit\n");
+        stats_writer.append(stats, lat);
+        stats_writer.close(stats);
+    }
     return 0;
 }
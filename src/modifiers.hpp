@@ -0,0 +1,136 @@
+#ifndef MARS_MODIFIERS_HPP
+#define MARS_MODIFIERS_HPP
+
+#include <array>       // std::array
+#include <cstddef>     // std::size_t
+#include <cstdint>     // uint8_t, uint32_t, uint64_t
+
+namespace effects {
+
+enum class ModOp : uint8_t {
+    Add,  // flat offset, applied before the factors
+    Mul,  // factor; several stack multiplicatively
+};
+
+// Same packing as EffectId: slot in the low 32 bits, generation in the high.
+using ModifierId = uint64_t;
+constexpr ModifierId kNoModifier = 0;
+
+// Concurrent modifiers on a small enum of stats (`Stat::COUNT` entries).
+// Each stat keeps a running aggregate -- summed offsets and the product of
+// factors -- that add() and remove() update in O(1), so reading a stat on
+// the hot path is a load or two instead of a walk over active effects:
+//
+//     value = (base + offset(stat)) * factor(stat)
+//
+// Removing a factor divides it back out. Zero factors are counted rather
+// than multiplied in so they can be removed too, and a stat whose last
+// modifier of a kind goes away snaps back to exactly 0 / 1, so rounding
+// can't accumulate across storms. Fixed-capacity inline storage, like
+// EffectStore, keeps copies allocation-free.
+template <class Stat, std::size_t Capacity>
+class StatModifiers {
+    static constexpr std::size_t kStats = static_cast<std::size_t>(Stat::COUNT);
+    static_assert(Capacity > 0 && Capacity < 0xFFFFFFFFu, "StatModifiers capacity");
+
+public:
+    StatModifiers() {
+        for (std::size_t i = 0; i < Capacity; ++i) free_[i] = static_cast<uint32_t>(Capacity - 1 - i);
+    }
+
+    // Returns kNoModifier when the set is full.
+    ModifierId add(Stat stat, ModOp op, double value) {
+        if (used_ == Capacity) return kNoModifier;
+        const uint32_t slot = free_[Capacity - 1 - used_++];
+        Slot& s = slots_[slot];
+        s.stat  = stat;
+        s.op    = op;
+        s.value = value;
+        s.live  = true;
+        Agg& a = agg_[index(stat)];
+        if (op == ModOp::Add) {
+            ++a.adds;
+            a.offset += value;
+        } else {
+            ++a.muls;
+            if (value == 0.0) ++a.zeros;
+            else a.product *= value;
+            a.factor = a.zeros ? 0.0 : a.product;
+        }
+        return (static_cast<uint64_t>(s.gen) << 32) | slot;
+    }
+
+    // Returns false for stale ids.
+    bool remove(ModifierId id) {
+        const uint32_t slot = static_cast<uint32_t>(id);
+        if (slot >= Capacity) return false;
+        Slot& s = slots_[slot];
+        if (!s.live || s.gen != static_cast<uint32_t>(id >> 32)) return false;
+        Agg& a = agg_[index(s.stat)];
+        if (s.op == ModOp::Add) {
+            a.offset = --a.adds ? a.offset - s.value : 0.0;
+        } else {
+            if (--a.muls == 0) {
+                a.zeros   = 0;
+                a.product = 1.0;
+            } else if (s.value == 0.0) {
+                --a.zeros;
+            } else {
+                a.product /= s.value;
+            }
+            a.factor = a.zeros ? 0.0 : a.product;
+        }
+        s.live = false;
+        if (++s.gen == 0) s.gen = 1;
+        free_[Capacity - used_--] = slot;
+        return true;
+    }
+
+    bool contains(ModifierId id) const {
+        const uint32_t slot = static_cast<uint32_t>(id);
+        return slot < Capacity && slots_[slot].live &&
+               slots_[slot].gen == static_cast<uint32_t>(id >> 32);
+    }
+
+    double offset(Stat stat) const { return agg_[index(stat)].offset; }
+    double factor(Stat stat) const { return agg_[index(stat)].factor; }
+    double apply(Stat stat, double base) const {
+        const Agg& a = agg_[index(stat)];
+        return (base + a.offset) * a.factor;
+    }
+
+    std::size_t size() const { return used_; }
+
+    // Generations survive, so ids handed out before clear() stay stale.
+    void clear() {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            if (slots_[i].live) remove((static_cast<uint64_t>(slots_[i].gen) << 32) | i);
+        }
+    }
+
+private:
+    struct Slot {
+        Stat     stat{};
+        ModOp    op    = ModOp::Add;
+        bool     live  = false;
+        uint32_t gen   = 1;
+        double   value = 0.0;
+    };
+    struct Agg {
+        double   factor  = 1.0;  // cached: zeros ? 0 : product
+        double   offset  = 0.0;
+        double   product = 1.0;  // of the non-zero factors
+        uint32_t adds = 0, muls = 0, zeros = 0;
+    };
+
+    static std::size_t index(Stat stat) { return static_cast<std::size_t>(stat); }
+
+    std::array<Agg, kStats>        agg_{};
+    std::array<Slot, Capacity>     slots_{};
+    std::array<uint32_t, Capacity> free_{};  // free_[0 .. Capacity - used_) are free
+    std::size_t                    used_ = 0;
+};
+
+} // namespace effects
+
+#endif // MARS_MODIFIERS_HPP
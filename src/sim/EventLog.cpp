@@ -0,0 +1,77 @@
+// EventLog.cpp
+#include "EventLog.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace sim;
+
+LogShard::LogShard() {
+    // Sized so ordinary ticks never grow the buffers.
+    recs_.reserve(256);
+    text_.reserve(16 * 1024);
+}
+
+void LogShard::emit(uint64_t tick, uint16_t system, uint32_t entity, std::string_view text) {
+    LogKey k{tick, system, entity, 0};
+    if (!recs_.empty()) {
+        const LogKey& last = recs_.back().key;
+        if (last.tick == tick && last.system == system && last.entity == entity) k.seq = last.seq + 1;
+    }
+    recs_.push_back(Record{k, static_cast<uint32_t>(text_.size()), static_cast<uint32_t>(text.size())});
+    text_.append(text.data(), text.size());
+}
+
+void OrderedLog::flush(const LogLineSink& sink) {
+    // Min-heap on key; ties are impossible between shards since an entity's
+    // lines for a system come from a single worker.
+    auto later = [](const Cursor& a, const Cursor& b) { return b.key < a.key; };
+    auto recLess = [](const LogShard::Record& a, const LogShard::Record& b) { return a.key < b.key; };
+
+    heap_.clear();
+    for (uint32_t s = 0; s < shards_.size(); ++s) {
+        auto& recs = shards_[s].recs_;
+        // Workers usually emit in order already; only sort when they did not.
+        if (!std::is_sorted(recs.begin(), recs.end(), recLess)) {
+            std::stable_sort(recs.begin(), recs.end(), recLess);
+        }
+        if (!recs.empty()) heap_.push_back(Cursor{recs[0].key, s, 0});
+    }
+    std::make_heap(heap_.begin(), heap_.end(), later);
+
+#ifndef NDEBUG
+    bool first = true;
+    LogKey prev;
+#endif
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        Cursor& c = heap_.back();
+        const LogShard& sh = shards_[c.shard];
+        const auto& r = sh.recs_[c.index];
+#ifndef NDEBUG
+        // A repeated key means `seq` restarted: an entity's lines for a
+        // system were split across workers or not emitted contiguously.
+        assert((first || prev < r.key) && "LogShard: non-contiguous lines for one entity");
+        first = false;
+        prev = r.key;
+#endif
+        if (sink) sink(r.key, std::string_view(sh.text_).substr(r.offset, r.length));
+        if (++c.index < sh.recs_.size()) {
+            c.key = sh.recs_[c.index].key;
+            std::push_heap(heap_.begin(), heap_.end(), later);
+        } else {
+            heap_.pop_back();
+        }
+    }
+
+    for (auto& sh : shards_) {
+        sh.recs_.clear();
+        sh.text_.clear();
+    }
+}
+
+std::string OrderedLog::format(const LogKey& k, std::string_view text) {
+    std::string out = "[tick " + std::to_string(k.tick) + " sys " + std::to_string(k.system) +
+                      " ent " + std::to_string(k.entity) + "] ";
+    out.append(text.data(), text.size());
+    return out;
+}
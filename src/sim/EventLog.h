@@ -0,0 +1,80 @@
+// EventLog.h
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sim {
+
+// Canonical position of a log line: ticks in order, then systems in their
+// fixed run order, then entities by id, then emission order for that entity.
+// Nothing in the key depends on which worker produced the line.
+struct LogKey {
+    uint64_t tick   = 0;
+    uint16_t system = 0;
+    uint32_t entity = 0;
+    uint32_t seq    = 0;
+
+    friend bool operator<(const LogKey& a, const LogKey& b) {
+        if (a.tick   != b.tick)   return a.tick   < b.tick;
+        if (a.system != b.system) return a.system < b.system;
+        if (a.entity != b.entity) return a.entity < b.entity;
+        return a.seq < b.seq;
+    }
+};
+
+using LogLineSink = std::function<void(const LogKey&, std::string_view)>;
+
+// Per-worker buffer. Exactly one thread writes a shard, so emit() takes no
+// lock; text is packed into one string so a line costs no allocation once
+// capacity has warmed up. A worker must emit all lines for one
+// (tick, system, entity) contiguously for `seq` to be canonical; flush()
+// asserts it in debug builds.
+class LogShard {
+public:
+    LogShard();
+    void emit(uint64_t tick, uint16_t system, uint32_t entity, std::string_view text);
+
+private:
+    friend class OrderedLog;
+    struct Record {
+        LogKey   key;
+        uint32_t offset;
+        uint32_t length;
+    };
+    std::vector<Record> recs_;
+    std::string         text_;
+};
+
+// Collects shards and merges them into canonical order at the tick boundary.
+class OrderedLog {
+public:
+    explicit OrderedLog(unsigned workers = 1) { set_workers(workers); }
+
+    void set_workers(unsigned n) {
+        shards_.resize(n ? n : 1);
+        heap_.reserve(shards_.size());
+    }
+    unsigned workers() const { return static_cast<unsigned>(shards_.size()); }
+    LogShard& shard(unsigned worker) { return shards_[worker]; }
+
+    // k-way merge of all shards into `sink` (may be empty), then clears them.
+    // Call from one thread once all workers for the tick have finished.
+    void flush(const LogLineSink& sink);
+
+    // "[tick 42 sys 2 ent 7] text" — convenience for text sinks.
+    static std::string format(const LogKey& k, std::string_view text);
+
+private:
+    struct Cursor {
+        LogKey   key;
+        uint32_t shard;
+        uint32_t index;
+    };
+    std::vector<LogShard> shards_;
+    std::vector<Cursor>   heap_; // reused across flushes
+};
+
+} // namespace sim
@@ -0,0 +1,85 @@
+// FramePacer.cpp
+#include "FramePacer.h"
+#include <thread>
+
+#if defined(__linux__)
+  #include <cerrno>
+  #include <ctime>
+#endif
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #include <immintrin.h>
+  #define MARS_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__)
+  #define MARS_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+  #define MARS_CPU_RELAX() std::this_thread::yield()
+#endif
+
+using namespace sim;
+
+uint64_t PacerStats::late_quantile_us(double q) const {
+    if (waits == 0) return 0;
+    const uint64_t target = static_cast<uint64_t>(q * static_cast<double>(waits - 1)) + 1;
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < kBuckets; ++b) {
+        seen += late_bucket[b];
+        if (seen >= target) return uint64_t{b + 1} * kBucketUs;
+    }
+    return late_max_ns / 1000;
+}
+
+static void sleep_until(FramePacer::Clock::time_point t) {
+#if defined(__linux__)
+    // libstdc++ and libc++ both build steady_clock on CLOCK_MONOTONIC, so the
+    // epoch offset carries over directly.
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    timespec ts;
+    ts.tv_sec  = static_cast<time_t>(ns / 1'000'000'000);
+    ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#else
+    std::this_thread::sleep_until(t);
+#endif
+}
+
+void FramePacer::wait_until(Clock::time_point deadline) {
+    using std::chrono::nanoseconds;
+    using std::chrono::duration_cast;
+
+    const auto start = Clock::now();
+    if (start >= deadline) return;   // behind: not a wait, not jitter
+
+    const auto wake = deadline - std::chrono::microseconds(spin_us_);
+    if (wake > start) sleep_until(wake);
+
+    const auto spin_start = Clock::now();
+    auto now = spin_start;
+    while (now < deadline) {
+        MARS_CPU_RELAX();
+        now = Clock::now();
+    }
+
+    const uint64_t late = static_cast<uint64_t>(duration_cast<nanoseconds>(now - deadline).count());
+    ++stats_.waits;
+    stats_.slept_ns    += static_cast<uint64_t>(duration_cast<nanoseconds>(spin_start - start).count());
+    stats_.spun_ns     += static_cast<uint64_t>(duration_cast<nanoseconds>(now - spin_start).count());
+    stats_.late_sum_ns += late;
+    if (late > stats_.late_max_ns) stats_.late_max_ns = late;
+    const uint64_t b = late / (PacerStats::kBucketUs * 1000);
+    ++stats_.late_bucket[b < PacerStats::kBuckets ? b : PacerStats::kBuckets];
+}
+
+FramePacer::Clock::time_point FramePacer::advance(Clock::time_point now, Clock::duration period) {
+    if (next_ == Clock::time_point{}) {
+        next_ = now;
+    } else if (now - next_ > period) {
+        next_ = now;
+        ++stats_.restarts;
+    }
+    next_ += period;
+    return next_;
+}
+
+void FramePacer::wait_next(Clock::duration period) {
+    wait_until(advance(Clock::now(), period));
+}
@@ -0,0 +1,61 @@
+// FramePacer.h
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace sim {
+
+// How close the pacer woke to its deadlines, and where the wait went.
+struct PacerStats {
+    static constexpr unsigned kBucketUs = 10;
+    static constexpr unsigned kBuckets  = 100;   // 0..1 ms in 10 us steps, then overflow
+
+    uint64_t waits     = 0;
+    uint64_t slept_ns  = 0;
+    uint64_t spun_ns   = 0;
+    uint64_t late_sum_ns = 0;
+    uint64_t late_max_ns = 0;
+    uint64_t restarts  = 0;    // wait_next() fell over a period behind
+    uint64_t late_bucket[kBuckets + 1] = {};
+
+    // Upper bound of the bucket holding quantile q of wake-up lateness.
+    uint64_t late_quantile_us(double q) const;
+};
+
+// Waits for frame deadlines without burning a core. The bulk of the wait is
+// an absolute-time sleep (clock_nanosleep on the monotonic clock where
+// available) that ends `spin_us` before the deadline; the remainder is a
+// pause-loop, which absorbs the scheduler's wake-up latency.
+//
+// A larger spin window buys accuracy with CPU. 200 us is enough to keep
+// wake-ups within ~10 us on an idle Linux host.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FramePacer(uint64_t spin_us = 200) : spin_us_(spin_us) {}
+
+    void     set_spin_us(uint64_t us) { spin_us_ = us; }
+    uint64_t spin_us() const          { return spin_us_; }
+
+    // Returns at or just after `deadline`; immediately if it has passed.
+    void wait_until(Clock::time_point deadline);
+
+    // Fixed-rate pacing: waits for the previous deadline plus `period`, so a
+    // late wake-up doesn't push every later frame back. More than a period
+    // behind, the schedule restarts from now rather than bursting to catch up.
+    void wait_next(Clock::duration period);
+    // wait_next()'s schedule without the wait: moves to the next deadline
+    // as seen at `now` and returns it.
+    Clock::time_point advance(Clock::time_point now, Clock::duration period);
+    Clock::time_point next_deadline() const { return next_; }
+
+    const PacerStats& stats() const { return stats_; }
+
+private:
+    uint64_t          spin_us_;
+    Clock::time_point next_{};   // last deadline handed to wait_until()
+    PacerStats        stats_;
+};
+
+} // namespace sim
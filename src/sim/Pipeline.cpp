@@ -0,0 +1,62 @@
+// Pipeline.cpp
+#include "Pipeline.h"
+
+using namespace sim;
+
+TickPipeline::TickPipeline(unsigned depth, Consumer consumer)
+    : slots_(depth ? depth : 1), consumer_(std::move(consumer)) {
+    worker_ = std::thread([this] { run(); });
+}
+
+TickPipeline::~TickPipeline() { finish(); }
+
+void TickPipeline::submit(const World& w, uint64_t tick, const Input& in) {
+    {
+        std::unique_lock<std::mutex> lk(m_);
+        if (count_ == slots_.size()) {
+            ++stalls_;
+            not_full_.wait(lk, [this] { return count_ < slots_.size(); });
+        }
+    }
+    // Single producer: slot head_ is ours until we publish it below.
+    Slot& s = slots_[head_];
+    s.world = w;
+    s.tick  = tick;
+    s.in    = in;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        head_ = (head_ + 1) % slots_.size();
+        ++count_;
+        ++submitted_;
+    }
+    not_empty_.notify_one();
+}
+
+void TickPipeline::run() {
+    for (;;) {
+        size_t idx;
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            not_empty_.wait(lk, [this] { return count_ > 0 || done_; });
+            if (count_ == 0) return; // done_ and drained
+            idx = tail_;
+        }
+        const Slot& s = slots_[idx];
+        if (consumer_) consumer_(s.world, s.tick, s.in);
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            tail_ = (tail_ + 1) % slots_.size();
+            --count_;
+        }
+        not_full_.notify_one();
+    }
+}
+
+void TickPipeline::finish() {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        done_ = true;
+    }
+    not_empty_.notify_one();
+    if (worker_.joinable()) worker_.join();
+}
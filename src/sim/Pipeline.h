@@ -0,0 +1,62 @@
+// Pipeline.h
+#pragma once
+#include "Simulation.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sim {
+
+// Overlaps per-tick bookkeeping (checksum, recording, trace I/O) with the
+// next tick. After each tick the sim thread copies the world into one of
+// `depth` snapshot slots and moves on; a worker thread hands each snapshot to
+// the consumer in tick order. When every slot is still in flight submit()
+// blocks, so the worker can never fall more than `depth` ticks behind.
+//
+// Slots keep their column capacity, so once warm a snapshot is a plain copy
+// with no allocation.
+class TickPipeline {
+public:
+    using Consumer = std::function<void(const World& snapshot, uint64_t tick, const Input& in)>;
+
+    TickPipeline(unsigned depth, Consumer consumer);
+    ~TickPipeline();
+
+    TickPipeline(const TickPipeline&) = delete;
+    TickPipeline& operator=(const TickPipeline&) = delete;
+
+    // `tick` is the tick `in` was applied to; `w` is the state after it.
+    void submit(const World& w, uint64_t tick, const Input& in);
+
+    // Waits for every submitted snapshot to be consumed and stops the worker.
+    void finish();
+
+    uint64_t submitted() const { return submitted_; }
+    uint64_t stalls()    const { return stalls_; }   // submits that had to wait
+
+private:
+    struct Slot {
+        World    world;
+        uint64_t tick = 0;
+        Input    in{};
+    };
+
+    void run();
+
+    std::vector<Slot>       slots_;
+    Consumer                consumer_;
+    std::mutex              m_;
+    std::condition_variable not_full_, not_empty_;
+    size_t                  head_  = 0;   // next slot to fill
+    size_t                  tail_  = 0;   // next slot to consume
+    size_t                  count_ = 0;   // filled or being consumed
+    bool                    done_  = false;
+    uint64_t                submitted_ = 0;
+    uint64_t                stalls_    = 0;
+    std::thread             worker_;
+};
+
+} // namespace sim
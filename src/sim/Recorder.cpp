@@ -1,5 +1,6 @@
 // Recorder.cpp
 #include "Recorder.h"
+#include "../io/AsyncWriter.h"
 #include <fstream>
 
 using namespace sim;
@@ -18,6 +19,18 @@ bool Recorder::save(const std::string& file) const {
     return true;
 }
 
+bool Recorder::save(mars::io::AsyncWriter& out, const std::string& file) const {
+    const int fd = out.open(file);
+    if (fd < 0) return false;
+    uint64_t n = events_.size();
+    out.append(fd, &n, sizeof n);
+    for (auto& [t, e] : events_) {
+        out.append(fd, &t, sizeof t);
+        out.append(fd, &e, sizeof e);
+    }
+    return out.close(fd);
+}
+
 bool Recorder::load(const std::string& file) {
     std::ifstream f(file, std::ios::binary);
     if (!f) return false;
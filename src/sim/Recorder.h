@@ -5,11 +5,15 @@
 #include <cstdint>
 #include <string>
 
+namespace mars::io { class AsyncWriter; }
+
 namespace sim {
 class Recorder {
 public:
     void push(uint64_t tick, const Input& in);
     bool save(const std::string& file) const;
+    // Same format, written through the async writer; completes before return.
+    bool save(mars::io::AsyncWriter& out, const std::string& file) const;
     bool load(const std::string& file);
     const std::vector<std::pair<uint64_t, Input>>& events() const { return events_; }
 
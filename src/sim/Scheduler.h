@@ -0,0 +1,93 @@
+// Scheduler.h
+#pragma once
+#include "../../include/mars/timing.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// System periods, in ticks of mars::kSimHz.
+inline constexpr uint32_t kTicksPerSecond = static_cast<uint32_t>(mars::kSimHz);
+inline constexpr uint32_t kTicksPerMinute = 60 * kTicksPerSecond;
+inline constexpr uint32_t kTicksPerHour   = 60 * kTicksPerMinute;
+inline constexpr uint32_t kTicksPerSol    = 24 * kTicksPerHour;   // 24 h sol, as in engine/state.hpp
+
+// Runs each registered system every `period` ticks instead of every tick.
+//
+// A system fires on ticks where tick % period == phase. Phases are picked
+// once, at registration, to keep systems off each other's ticks: for every
+// candidate phase we add up the cost of already-registered systems that would
+// ever fire on the same tick (phase p of period P meets phase q of period Q
+// iff p == q mod gcd(P, Q)) and take the cheapest, lowest phase first. That
+// depends only on registration order, periods and costs, so replays agree.
+//
+// Within a tick, due systems run in registration order. A system is told how
+// many ticks have elapsed since it last ran so it can integrate over them:
+// its period, except on its first run, which covers ticks 0..phase.
+template <class Ctx>
+class SystemScheduler {
+public:
+    using Fn = void (Ctx::*)(uint32_t ticks);
+
+    struct Entry {
+        uint16_t id;
+        uint32_t period;
+        uint32_t phase;
+        uint32_t cost;
+        Fn       fn;
+    };
+
+    // `cost` is a relative weight for phase placement, e.g. expected us.
+    const Entry& add(uint16_t id, uint32_t period, Fn fn, uint32_t cost = 1) {
+        if (period == 0) period = 1;
+        entries_.push_back(Entry{id, period, pick_phase(period), cost, fn});
+        return entries_.back();
+    }
+
+    void run(Ctx& ctx, uint64_t tick) const {
+        for (const Entry& e : entries_) {
+            if (due(e, tick)) (ctx.*e.fn)(elapsed(e, tick));
+        }
+    }
+
+    // Summed cost of the systems that fire on `tick`.
+    uint64_t load(uint64_t tick) const {
+        uint64_t sum = 0;
+        for (const Entry& e : entries_) {
+            if (due(e, tick)) sum += e.cost;
+        }
+        return sum;
+    }
+
+    const std::vector<Entry>& entries() const { return entries_; }
+
+private:
+    static bool due(const Entry& e, uint64_t tick) { return tick % e.period == e.phase; }
+    // Ticks since the previous due tick; the first run counts from tick 0.
+    static uint32_t elapsed(const Entry& e, uint64_t tick) {
+        return tick < e.period ? static_cast<uint32_t>(tick) + 1 : e.period;
+    }
+
+    static uint32_t gcd(uint32_t a, uint32_t b) {
+        while (b) { const uint32_t t = a % b; a = b; b = t; }
+        return a;
+    }
+
+    uint32_t pick_phase(uint32_t period) const {
+        uint32_t best = 0;
+        uint64_t bestCost = UINT64_MAX;
+        for (uint32_t p = 0; p < period && bestCost != 0; ++p) {
+            uint64_t c = 0;
+            for (const Entry& e : entries_) {
+                if (e.period == 1) continue;   // shares every tick whatever we pick
+                if (p % gcd(period, e.period) == e.phase % gcd(period, e.period)) c += e.cost;
+            }
+            if (c < bestCost) { bestCost = c; best = p; }
+        }
+        return best;
+    }
+
+    std::vector<Entry> entries_;
+};
+
+} // namespace sim
@@ -1,6 +1,26 @@
 #pragma once
 #include <cstdint>
 
+// What to do when ticks cost more wall time than the frame allows.
+enum class LagPolicy : std::uint8_t {
+    Drop,      // keep the requested speed; discard debt the budget can't repay
+    SlowDown,  // lower the effective speed to what the budget sustains
+};
+
+// Per-frame figures, refreshed by advance_by_frame_us().
+struct SimClockStats {
+    std::uint64_t frames              = 0;
+    std::uint64_t frame_us            = 0;  // wall time of the last frame
+    std::uint64_t stepping_us         = 0;  // wall time spent in steps last frame
+    std::uint64_t tick_cost_us        = 0;  // EWMA of one step's wall cost
+    std::uint32_t steps_last_frame    = 0;
+    std::uint32_t step_budget         = 0;  // steps allowed this frame
+    std::uint64_t backlog_ticks       = 0;  // whole steps owed after crediting
+    std::uint64_t dropped_us          = 0;  // sim time discarded, cumulative
+    std::uint32_t requested_speed_q16 = 0;
+    std::uint32_t effective_speed_q16 = 0;  // sim us per wall us, last window
+};
+
 class SimClock {
 public:
     // step_us: simulation step duration (microseconds), e.g. 100'000 = 10 Hz
@@ -17,26 +37,122 @@ public:
         speed_q16_ = static_cast<std::uint32_t>(s * 65536.0 + 0.5);
     }
 
+    // Wall time per frame we are willing to spend stepping. The step budget
+    // is this divided by the measured tick cost, never less than one step.
+    void set_frame_budget_us(std::uint64_t us) { budget_us_ = us ? us : 1; }
+    // Frames longer than this (debugger, suspend) are credited as this long.
+    void set_max_frame_us(std::uint64_t us)    { max_frame_us_ = us ? us : 1; }
+    void set_lag_policy(LagPolicy p)           { policy_ = p; }
+
     // Advance the clock by wall-clock microseconds since the last frame.
     inline void advance_by_frame_us(std::uint64_t frame_us) {
+        close_frame(frame_us);
+        if (frame_us > max_frame_us_) frame_us = max_frame_us_;
+
+        const std::uint64_t cost = tick_cost_us();
+        std::uint64_t budget = cost ? budget_us_ / cost : kMaxStepsPerFrame;
+        if (budget < 1) budget = 1;
+        if (budget > kMaxStepsPerFrame) budget = kMaxStepsPerFrame;
+        step_budget_ = static_cast<std::uint32_t>(budget);
+
+        std::uint64_t speed = speed_q16_;
+        if (policy_ == LagPolicy::SlowDown && frame_us) {
+            // Fastest rate at which this frame's budget keeps the debt flat.
+            const std::uint64_t sustainable = ((budget * step_us_) << 16) / frame_us;
+            if (sustainable < speed) speed = sustainable;
+        }
         // (frame_us * speed_q16) >> 16 — all integer math
-        acc_us_ += (frame_us * static_cast<std::uint64_t>(speed_q16_)) >> 16;
+        acc_us_ += (frame_us * speed) >> 16;
+        credit_q16_ = speed;
+
+        // Never carry more debt than one frame's budget can repay. Under
+        // SlowDown this only trips on a sudden cost spike.
+        const std::uint64_t cap = budget * step_us_ + (acc_us_ % step_us_);
+        if (acc_us_ > cap) {
+            stats_.dropped_us += acc_us_ - cap;
+            acc_us_ = cap;
+        }
+
+        stats_.step_budget         = step_budget_;
+        stats_.backlog_ticks       = acc_us_ / step_us_;
+        stats_.requested_speed_q16 = speed_q16_;
+        stats_.tick_cost_us        = cost;
     }
 
-    inline bool step_ready() const { return acc_us_ >= step_us_; }
+    inline bool step_ready() const {
+        return acc_us_ >= step_us_ && steps_this_frame_ < step_budget_;
+    }
 
     inline void consume_step() {
         acc_us_ -= step_us_;
         ++tick_;
+        ++steps_this_frame_;
+    }
+
+    // As above, also feeding the step's measured wall cost into the budget.
+    inline void consume_step(std::uint64_t cost_us) {
+        consume_step();
+        stepping_us_ += cost_us;
+        const std::int64_t x = static_cast<std::int64_t>(cost_us << kCostFrac);
+        cost_q_ += (x - cost_q_) / kCostEwmaDiv;
     }
 
     inline std::uint64_t tick()    const { return tick_;    }
     inline std::uint64_t step_us() const { return step_us_; }
     inline std::uint64_t acc_us()  const { return acc_us_;  }
+    // Wall time until the next step is due at the current credit rate; 0 if
+    // one is due already (even if this frame's budget is spent).
+    inline std::uint64_t us_until_next_step() const {
+        if (acc_us_ >= step_us_) return 0;
+        if (credit_q16_ == 0) return max_frame_us_;   // paused
+        return (((step_us_ - acc_us_) << 16) + credit_q16_ - 1) / credit_q16_;
+    }
+    // Wall time per step at the current credit rate: the frame period for a
+    // pacer that wakes once per step.
+    inline std::uint64_t wall_us_per_step() const {
+        if (credit_q16_ == 0) return max_frame_us_;   // paused
+        return ((step_us_ << 16) + credit_q16_ - 1) / credit_q16_;
+    }
+    inline std::uint64_t tick_cost_us() const { return static_cast<std::uint64_t>(cost_q_) >> kCostFrac; }
+    inline const SimClockStats& stats() const { return stats_; }
 
 private:
+    static constexpr std::uint64_t kMaxStepsPerFrame = 64;
+    static constexpr unsigned      kCostFrac    = 8;  // cost EWMA in Q8 us
+    static constexpr std::int64_t  kCostEwmaDiv = 8;  // alpha = 1/8
+    static constexpr std::uint64_t kSpeedWindowUs = 500'000;
+
+    // Folds the frame that just ended into the stats before crediting the next.
+    inline void close_frame(std::uint64_t frame_us) {
+        win_sim_us_  += steps_this_frame_ * step_us_;
+        win_wall_us_ += frame_us;
+        if (win_wall_us_ >= kSpeedWindowUs) {
+            const std::uint64_t eff = (win_sim_us_ << 16) / win_wall_us_;
+            stats_.effective_speed_q16 = eff > UINT32_MAX ? UINT32_MAX : static_cast<std::uint32_t>(eff);
+            win_sim_us_ = win_wall_us_ = 0;
+        }
+        stats_.frames          += 1;
+        stats_.frame_us         = frame_us;
+        stats_.stepping_us      = stepping_us_;
+        stats_.steps_last_frame = steps_this_frame_;
+        steps_this_frame_ = 0;
+        stepping_us_      = 0;
+    }
+
     std::uint64_t step_us_;
     std::uint64_t acc_us_;
     std::uint64_t tick_;
     std::uint32_t speed_q16_;  // 1.0x == 65536
+
+    LagPolicy     policy_       = LagPolicy::Drop;
+    std::uint64_t budget_us_    = 50'000;
+    std::uint64_t max_frame_us_ = 250'000;
+    std::int64_t  cost_q_       = 0;   // tick cost EWMA, Q8 us
+    std::uint64_t credit_q16_   = 1u << 16;  // speed actually credited last frame
+    std::uint64_t win_sim_us_   = 0;   // effective-speed window
+    std::uint64_t win_wall_us_  = 0;
+    std::uint32_t step_budget_  = static_cast<std::uint32_t>(kMaxStepsPerFrame);
+    std::uint32_t steps_this_frame_ = 0;
+    std::uint64_t stepping_us_  = 0;
+    SimClockStats stats_;
 };
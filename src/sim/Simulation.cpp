@@ -1,33 +1,67 @@
 #include "Simulation.h"
+#include "../../include/mars/latency.hpp"
+
+// Registration order is run order within a tick; keep it *constant* for
+// determinism. Slow-moving systems run on a period, phases staggered.
+sim::Simulation::Simulation(uint64_t seed) : rng_(seed) {
+    sched_.add(static_cast<uint16_t>(SystemId::Thermal),       1,               &Simulation::system_thermal);
+    sched_.add(static_cast<uint16_t>(SystemId::PowerGrid),     kTicksPerSecond, &Simulation::system_power_grid);
+    sched_.add(static_cast<uint16_t>(SystemId::LifeSupport),   1,               &Simulation::system_life_support);
+    sched_.add(static_cast<uint16_t>(SystemId::ColonistNeeds), kTicksPerSecond, &Simulation::system_colonist_needs);
+}
 
-// Example system order. Keep the order *constant* for determinism.
 void sim::Simulation::tick(const Input& input) {
+    static mars::LatencyMetric& tick_lat = mars::latency_metric("sim.tick");
+    mars::ScopedLatency timed(tick_lat);
+
     (void)input; // apply inputs here deterministically
 
-    system_power_grid();
-    system_life_support();
-    system_colonist_needs();
+    sched_.run(*this, world_.tick);
 
+    log_.flush(log_sink_);
     world_.tick++;
+    frame_.reset();
+}
+
+void sim::Simulation::system_thermal(uint32_t ticks) {
+    static mars::LatencyMetric& lat = mars::latency_metric("sim.thermal");
+    mars::ScopedLatency timed(lat);
+    // Body temperature relaxes toward 293 K, at most 20 mK per tick.
+    const int32_t step = 20 * static_cast<int32_t>(ticks);
+    for (auto& c : world_.colonists) {
+        const int32_t d = 293'000 - c.temp_milK;
+        c.temp_milK += d > step ? step : (d < -step ? -step : d);
+    }
 }
 
-void sim::Simulation::system_power_grid() {
+void sim::Simulation::system_power_grid(uint32_t) {
+    static mars::LatencyMetric& lat = mars::latency_metric("sim.power_grid");
+    mars::ScopedLatency timed(lat);
     // Example: clamp milli-Watts, avoid floating point
     for (auto& h : world_.habitats) {
         if (h.power_mW < 0) h.power_mW = 0;
     }
 }
-void sim::Simulation::system_life_support() {
+void sim::Simulation::system_life_support(uint32_t ticks) {
+    static mars::LatencyMetric& lat = mars::latency_metric("sim.life_support");
+    mars::ScopedLatency timed(lat);
     for (auto& h : world_.habitats) {
         // toy example: pressure bleeds if power low
         if (h.power_mW < 10'000) {
-            h.pressure_mPa -= 50; // deterministic integer math
+            h.pressure_mPa -= 50 * static_cast<int32_t>(ticks); // deterministic integer math
         }
     }
 }
-void sim::Simulation::system_colonist_needs() {
+void sim::Simulation::system_colonist_needs(uint32_t ticks) {
+    static mars::LatencyMetric& lat = mars::latency_metric("sim.colonist_needs");
+    mars::ScopedLatency timed(lat);
+    LogShard& out = log_.shard(0);
     for (auto& c : world_.colonists) {
-        c.oxygen_mg -= 5; // deterministic consumption per tick
+        const bool had_oxygen = c.oxygen_mg > 0;
+        c.oxygen_mg -= 5 * static_cast<int32_t>(ticks); // deterministic consumption per tick
         if (c.oxygen_mg < 0) c.oxygen_mg = 0;
+        if (had_oxygen && c.oxygen_mg == 0) {
+            out.emit(world_.tick, static_cast<uint16_t>(SystemId::ColonistNeeds), c.id, "oxygen depleted");
+        }
     }
 }
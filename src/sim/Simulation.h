@@ -1,6 +1,9 @@
 #pragma once
 #include "World.h"
 #include "Rng.h"
+#include "EventLog.h"
+#include "Scheduler.h"
+#include "../../include/mars/frame_arena.hpp"
 
 namespace sim {
 
@@ -10,23 +13,44 @@ struct Input {
     int32_t example_command = 0;
 };
 
+// Tag for log lines and scheduler entries. Values are stable across
+// releases; run order is the registration order in the constructor.
+enum class SystemId : uint16_t { PowerGrid = 0, LifeSupport = 1, ColonistNeeds = 2, Thermal = 3 };
+
 class Simulation {
 public:
-    explicit Simulation(uint64_t seed = 0) : rng_(seed) {}
+    explicit Simulation(uint64_t seed = 0);
     World& world()       { return world_; }
     const World& world() const { return world_; }
 
     // advance exactly one tick
     void tick(const Input& input);
 
+    // Scratch memory for this tick only; reset when tick() returns.
+    mars::FrameArena& frame() { return frame_; }
+
+    // Which systems run on which ticks.
+    const SystemScheduler<Simulation>& schedule() const { return sched_; }
+
+    // Systems log into per-worker shards; lines reach the sink in canonical
+    // (tick, system, entity, seq) order at the end of each tick.
+    OrderedLog& log() { return log_; }
+    void set_log_sink(LogLineSink sink) { log_sink_ = std::move(sink); }
+
 private:
     World world_;
     Rng   rng_;
+    mars::FrameArena frame_;
+    OrderedLog  log_;
+    LogLineSink log_sink_;
+    SystemScheduler<Simulation> sched_;
 
-    // split your systems into private helpers; call them in a fixed order
-    void system_life_support();
-    void system_colonist_needs();
-    void system_power_grid();
+    // Systems are private helpers registered with sched_; each is passed
+    // the ticks elapsed since it last ran and advances state by that much.
+    void system_thermal(uint32_t ticks);
+    void system_life_support(uint32_t ticks);
+    void system_colonist_needs(uint32_t ticks);
+    void system_power_grid(uint32_t ticks);
 };
 
 } // namespace sim
@@ -1,5 +1,6 @@
 #include "World.h"
 #include "determinism/state_hash.hpp"
+#include "determinism/reduce.hpp"
 
 using namespace sim;
 
@@ -10,3 +11,17 @@ uint64_t World::checksum() const noexcept {
     h = sim::det::fnv1a64(h, habitats.data(), habitats.size() * sizeof(Habitat));
     return h;
 }
+
+ColonyTotals World::totals(unsigned threads) const {
+    ColonyTotals t;
+    const Colonist* c = colonists.data();
+    const Habitat*  h = habitats.data();
+    t.oxygen_mg  = det::int_sum_by(colonists.size(), [c](size_t i) { return int64_t{c[i].oxygen_mg}; }, threads);
+    t.co2_mg     = det::int_sum_by(colonists.size(), [c](size_t i) { return int64_t{c[i].co2_mg}; }, threads);
+    t.stress_mil = det::int_sum_by(colonists.size(), [c](size_t i) { return int64_t{c[i].stress_mil}; }, threads);
+    t.power_mW   = det::int_sum_by(habitats.size(),  [h](size_t i) { return int64_t{h[i].power_mW}; }, threads);
+    if (!colonists.empty()) {
+        t.avg_stress_mil = static_cast<int32_t>(t.stress_mil / static_cast<int64_t>(colonists.size()));
+    }
+    return t;
+}
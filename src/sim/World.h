@@ -3,6 +3,7 @@
 #include <vector>
 #include <string>
 #include <string_view>
+#include "../../include/mars/huge_pages.hpp"
 
 namespace sim {
 
@@ -23,13 +24,28 @@ struct Habitat {
     int32_t  power_mW;       // milli-Watts available
 };
 
+// Colony-wide aggregates; bit-identical for any thread count.
+struct ColonyTotals {
+    int64_t oxygen_mg       = 0;
+    int64_t co2_mg          = 0;
+    int64_t power_mW        = 0;
+    int64_t stress_mil      = 0;
+    int32_t avg_stress_mil  = 0;  // truncated toward zero
+};
+
+// Entity storage. Large columns are mmap-backed and can be put on 2 MiB
+// pages via mars::set_huge_page_mode() (or MARS_HUGE_PAGES=thp|hugetlb).
+template <class T>
+using Column = std::vector<T, mars::HugePageAllocator<T>>;
+
 struct World {
     uint64_t tick = 0;
-    std::vector<Colonist> colonists;
-    std::vector<Habitat>  habitats;
+    Column<Colonist> colonists;
+    Column<Habitat>  habitats;
 
     // Simple, stable checksum over state for tests/replays.
     uint64_t checksum() const noexcept;
+    ColonyTotals totals(unsigned threads = 1) const;
     std::string serialize_binary() const; // optional convenience
     static World deserialize_binary(std::string_view bytes);
 };
@@ -0,0 +1,99 @@
+// src/systems/battery_wear.cpp
+#include "battery_wear.h"
+#include <algorithm>
+#include <cmath>
+
+namespace mars::power {
+
+static double cycle_damage(double range, const WearConfig& cfg) {
+    return std::pow(range, cfg.exponent) / cfg.cyclesAt100;
+}
+
+static void count(WearState& w, double range, double weight, const WearConfig& cfg) {
+    w.damage += weight * cycle_damage(range, cfg);
+    w.cycles += weight;
+}
+
+static void drop_front(WearState& w, std::size_t k) {
+    for (std::size_t i = k; i < w.depth; ++i) w.rev[i - k] = w.rev[i];
+    w.depth = static_cast<std::uint8_t>(w.depth - k);
+}
+
+// Four-point rainflow on the reversal stack (ASTM E1049, sec. 5.4.4): a range
+// no larger than the one after it closes a full cycle, unless it starts at the
+// oldest point, in which case it is half a cycle and that point is retired.
+static void push_reversal(WearState& w, double x, const WearConfig& cfg) {
+    if (w.depth == kWearStack) {
+        count(w, std::fabs(w.rev[1] - w.rev[0]), 0.5, cfg);
+        drop_front(w, 1);
+    }
+    w.rev[w.depth++] = x;
+    while (w.depth >= 3) {
+        const std::size_t n = w.depth;
+        const double X = std::fabs(w.rev[n - 1] - w.rev[n - 2]);
+        const double Y = std::fabs(w.rev[n - 2] - w.rev[n - 3]);
+        if (X < Y) break;
+        if (n == 3) {
+            count(w, Y, 0.5, cfg);
+            drop_front(w, 1);
+        } else {
+            count(w, Y, 1.0, cfg);
+            w.rev[n - 3] = w.rev[n - 1];
+            w.depth = static_cast<std::uint8_t>(n - 2);
+        }
+    }
+}
+
+void wear_init(WearState& w, double nominalWh, double soc) {
+    w = WearState{};
+    w.nominalWh = nominalWh;
+    w.peak      = soc;
+    w.rev[0]    = soc;
+    w.depth     = 1;
+}
+
+double wear_update(WearState& w, double soc, const WearConfig& cfg) {
+    // Turning points, with swings below the hysteresis ignored.
+    if (w.dir == 0) {
+        if (std::fabs(soc - w.peak) >= cfg.hysteresis) {
+            w.dir  = soc > w.peak ? 1 : -1;
+            w.peak = soc;
+        }
+    } else if ((w.dir > 0) == (soc > w.peak)) {
+        w.peak = soc;                                   // swing continues
+    } else if (std::fabs(soc - w.peak) >= cfg.hysteresis) {
+        push_reversal(w, w.peak, cfg);
+        w.dir  = static_cast<std::int8_t>(-w.dir);
+        w.peak = soc;
+    }
+    return w.nominalWh * std::max(0.0, 1.0 - cfg.fadeAtEnd * w.damage);
+}
+
+double wear_damage_with_residue(const WearState& w, const WearConfig& cfg) {
+    double d = w.damage;
+    for (std::size_t i = 1; i < w.depth; ++i) d += 0.5 * cycle_damage(std::fabs(w.rev[i] - w.rev[i - 1]), cfg);
+    if (w.dir != 0 && w.depth > 0) d += 0.5 * cycle_damage(std::fabs(w.peak - w.rev[w.depth - 1]), cfg);
+    return d;
+}
+
+static void apply_wear(double& storedWh, double& capacityWh, WearState& w, const WearConfig& cfg) {
+    const double soc = capacityWh > 0.0 ? storedWh / capacityWh : 0.0;
+    capacityWh = wear_update(w, soc, cfg);
+    storedWh   = std::min(storedWh, capacityWh);
+}
+
+State step(State s, const Inputs& in, const Config& cfg, Result& out,
+           WearState& wear, const WearConfig& wcfg) {
+    s = step(s, in, cfg, out);
+    apply_wear(s.storedWh, s.capacityWh, wear, wcfg);
+    return s;
+}
+
+void step_batch(std::size_t n, const StateSoA& s, const InputsSoA& in,
+                const Config& cfg, const ResultSoA& out,
+                WearState* wear, const WearConfig& wcfg) {
+    step_batch(n, s, in, cfg, out);
+    for (std::size_t i = 0; i < n; ++i) apply_wear(s.storedWh[i], s.capacityWh[i], wear[i], wcfg);
+}
+
+} // namespace mars::power
@@ -0,0 +1,56 @@
+// src/systems/battery_wear.h
+#pragma once
+#include "power_system.h"
+#include <cstddef>
+#include <cstdint>
+
+// Cycle-count battery wear. The state-of-charge series is fed one sample per
+// step and rainflow-counted online; each closed cycle adds damage
+// DoD^exponent / cyclesAt100, and capacity fades linearly with damage.
+
+namespace mars::power {
+
+struct WearConfig {
+    double cyclesAt100 = 3000.0;  // full 0-100% cycles to end of life
+    double exponent    = 2.0;     // Woehler exponent: N(DoD) = cyclesAt100 * DoD^-exponent
+    double fadeAtEnd   = 0.2;     // capacity lost at damage 1.0
+    double hysteresis  = 0.001;   // SoC swings smaller than this are not reversals
+};
+
+// Reversals still waiting for a partner. A rainflow residue only grows while
+// swings keep shrinking, so a short stack suffices; on overflow the oldest
+// reversal is retired as a half cycle.
+inline constexpr std::size_t kWearStack = 16;
+
+struct WearState {
+    double       nominalWh = 0.0;
+    double       damage    = 0.0;    // Miner's sum
+    double       cycles    = 0.0;    // counted cycles, halves included
+    double       peak      = 0.0;    // running extremum of the current swing
+    std::int8_t  dir       = 0;      // +1 charging, -1 discharging, 0 not yet known
+    std::uint8_t depth     = 0;      // reversals on the stack
+    double       rev[kWearStack] = {};
+};
+
+// Starts tracking a pack of `nominalWh` currently at `soc` (0..1).
+void wear_init(WearState& w, double nominalWh, double soc);
+
+// Feeds one SoC sample. Returns the faded capacity in Wh.
+double wear_update(WearState& w, double soc, const WearConfig& cfg);
+
+// Damage if the history ended now: open reversals count as half cycles.
+// Does not modify `w`.
+double wear_damage_with_residue(const WearState& w, const WearConfig& cfg);
+
+// step() followed by a wear update: capacityWh fades and storedWh is clamped
+// to it.
+State step(State s, const Inputs& in, const Config& cfg, Result& out,
+           WearState& wear, const WearConfig& wcfg);
+
+// step_batch() followed by a wear update per lane. The power math stays
+// vectorised; rainflow is branchy and runs per battery.
+void step_batch(std::size_t n, const StateSoA& s, const InputsSoA& in,
+                const Config& cfg, const ResultSoA& out,
+                WearState* wear, const WearConfig& wcfg);
+
+} // namespace mars::power
@@ -0,0 +1,264 @@
+// src/systems/deposits.cpp
+#include "deposits.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define MARS_DEPOSITS_SSE2 1
+#endif
+
+namespace mars::deposits {
+
+namespace {
+
+constexpr uint32_t kX = 0x8da6b343u;  // lattice hash: x, y multipliers
+constexpr uint32_t kY = 0xd8163841u;
+constexpr int      kMaxOctaves = 25;  // baseShift 24 down to 0
+
+struct Octave {
+    uint32_t seed, shift, mask;
+    float    invCell, amp;
+};
+
+// Everything about one resource's noise that doesn't depend on the cell.
+struct Plan {
+    Octave oct[kMaxOctaves];
+    int    n;
+    float  norm, floor, invSpan;
+};
+
+Plan plan(const Params& p, Resource r) {
+    Plan pl{};
+    const int baseShift = std::clamp(p.baseShift, 0, kMaxOctaves - 1);
+    pl.n = std::clamp(p.octaves, 1, baseShift + 1);
+    const uint32_t seed = p.seed ^ (r == Resource::Ice ? 0x9c8f1e4bu : 0x3b5d27a1u);
+    float amp = 1.0f, sum = 0.0f;
+    for (int o = 0; o < pl.n; ++o) {
+        const uint32_t shift = static_cast<uint32_t>(baseShift - o);
+        pl.oct[o] = Octave{seed + static_cast<uint32_t>(o) * 0x9e3779b9u, shift, (1u << shift) - 1u,
+                           1.0f / static_cast<float>(1u << shift), amp};
+        sum += amp;
+        amp *= 0.5f;
+    }
+    pl.norm    = 1.0f / sum;
+    pl.floor   = r == Resource::Ice ? p.iceFloor : p.metalsFloor;
+    pl.invSpan = 1.0f / (1.0f - pl.floor);
+    return pl;
+}
+
+// Signed cells map monotonically onto unsigned ones, so shifts and masks
+// floor negative coordinates the same way as positive ones.
+inline uint32_t bias(int32_t v) { return static_cast<uint32_t>(v) ^ 0x80000000u; }
+inline int32_t unbias(uint32_t u) { return static_cast<int32_t>(u ^ 0x80000000u); }
+
+inline uint32_t mix(uint32_t h) {
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    h *= 0x297a2d39u;
+    h ^= h >> 15;
+    return h;
+}
+
+inline float unit(uint32_t h) { return static_cast<float>(static_cast<int32_t>(h >> 8)) * (1.0f / 16777216.0f); }
+inline float fade(float t) { return t * t * (3.0f - 2.0f * t); }
+inline float lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+float at(const Plan& pl, uint32_t ux, uint32_t uy) {
+    float acc = 0.0f;
+    for (int o = 0; o < pl.n; ++o) {
+        const Octave& k = pl.oct[o];
+        const uint32_t cx = ux >> k.shift, cy = uy >> k.shift;
+        const float sx = fade(static_cast<float>(static_cast<int32_t>(ux & k.mask)) * k.invCell);
+        const float sy = fade(static_cast<float>(static_cast<int32_t>(uy & k.mask)) * k.invCell);
+        const uint32_t row0 = cy * kY ^ k.seed, row1 = (cy + 1u) * kY ^ k.seed;
+        const float v0 = lerp(unit(mix(cx * kX ^ row0)), unit(mix((cx + 1u) * kX ^ row0)), sx);
+        const float v1 = lerp(unit(mix(cx * kX ^ row1)), unit(mix((cx + 1u) * kX ^ row1)), sx);
+        acc = acc + lerp(v0, v1, sy) * k.amp;
+    }
+    return std::max(0.0f, (acc * pl.norm - pl.floor) * pl.invSpan);
+}
+
+#ifdef MARS_DEPOSITS_SSE2
+// SSE2 has no 32-bit low multiply; two 32x32->64 products give the lanes.
+inline __m128i mullo(__m128i a, __m128i b) {
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+inline __m128 unit4(__m128i h) {
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+    h = mullo(h, _mm_set1_epi32(static_cast<int>(0x2c1b3c6du)));
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 12));
+    h = mullo(h, _mm_set1_epi32(static_cast<int>(0x297a2d39u)));
+    h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+    return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(h, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+}
+
+inline __m128 lerp4(__m128 a, __m128 b, __m128 t) { return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)); }
+
+// at() for cells ux .. ux + 3 of one row. The y terms are shared by the
+// lanes and computed once in scalar.
+void at4(const Plan& pl, uint32_t ux, uint32_t uy, float* out) {
+    const __m128i x  = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(ux)), _mm_setr_epi32(0, 1, 2, 3));
+    const __m128i kx = _mm_set1_epi32(static_cast<int>(kX));
+    const __m128i one = _mm_set1_epi32(1);
+    __m128 acc = _mm_setzero_ps();
+    for (int o = 0; o < pl.n; ++o) {
+        const Octave& k = pl.oct[o];
+        const __m128i cx = _mm_srl_epi32(x, _mm_cvtsi32_si128(static_cast<int>(k.shift)));
+        const __m128  fx = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(x, _mm_set1_epi32(static_cast<int>(k.mask)))),
+                                      _mm_set1_ps(k.invCell));
+        const __m128  sx = _mm_mul_ps(_mm_mul_ps(fx, fx), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), fx)));
+        const uint32_t cy = uy >> k.shift;
+        const float    sy = fade(static_cast<float>(static_cast<int32_t>(uy & k.mask)) * k.invCell);
+        const __m128i row0 = _mm_set1_epi32(static_cast<int>(cy * kY ^ k.seed));
+        const __m128i row1 = _mm_set1_epi32(static_cast<int>((cy + 1u) * kY ^ k.seed));
+        const __m128i h0 = mullo(cx, kx);
+        const __m128i h1 = mullo(_mm_add_epi32(cx, one), kx);
+        const __m128 v0 = lerp4(unit4(_mm_xor_si128(h0, row0)), unit4(_mm_xor_si128(h1, row0)), sx);
+        const __m128 v1 = lerp4(unit4(_mm_xor_si128(h0, row1)), unit4(_mm_xor_si128(h1, row1)), sx);
+        acc = _mm_add_ps(acc, _mm_mul_ps(lerp4(v0, v1, _mm_set1_ps(sy)), _mm_set1_ps(k.amp)));
+    }
+    const __m128 v = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(acc, _mm_set1_ps(pl.norm)), _mm_set1_ps(pl.floor)),
+                                _mm_set1_ps(pl.invSpan));
+    // MAXPS returns its second operand unless the first is greater, as std::max(0, v) does.
+    _mm_storeu_ps(out, _mm_max_ps(v, _mm_setzero_ps()));
+}
+#endif
+
+void fill_row(const Plan& pl, uint32_t ux, uint32_t uy, std::size_t n, float* out) {
+    std::size_t i = 0;
+#ifdef MARS_DEPOSITS_SSE2
+    const std::size_t n4 = n & ~std::size_t{3};
+    for (; i < n4; i += 4) at4(pl, ux + static_cast<uint32_t>(i), uy, out + i);
+#endif
+    for (; i < n; ++i) out[i] = at(pl, ux + static_cast<uint32_t>(i), uy);
+}
+
+} // namespace
+
+float sample(const Params& p, Resource r, int32_t x, int32_t y) {
+    return at(plan(p, r), bias(x), bias(y));
+}
+
+void sample_row(const Params& p, Resource r, int32_t x0, int32_t y, std::size_t n, float* out) {
+    fill_row(plan(p, r), bias(x0), bias(y), n, out);
+}
+
+Field::Field(const Params& p, std::size_t maxTiles) : params_(p), maxTiles_(std::max<std::size_t>(maxTiles, 1)) {
+    tiles_.reserve(maxTiles_);
+}
+
+void Field::reset(const Params& p) {
+    params_ = p;
+    tiles_.clear();
+    index_.clear();
+    head_ = tail_ = kNil;
+    stats_ = Stats{};
+}
+
+float Field::richness(Resource r, int32_t x, int32_t y) {
+    const uint32_t ux = bias(x), uy = bias(y);
+    const Tile& t = tile(ux >> kTileShift, uy >> kTileShift);
+    const uint32_t m = kTileSize - 1;
+    return t.value[static_cast<int>(r)][(uy & m) * kTileSize + (ux & m)];
+}
+
+Site Field::best_site(Resource r, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    Site best;
+    if (x0 >= x1 || y0 >= y1) return best;
+    const int ri = static_cast<int>(r);
+    const uint32_t m = kTileSize - 1;
+    const uint32_t ux0 = bias(x0), ux1 = bias(x1) - 1u;  // inclusive
+    const uint32_t uy0 = bias(y0), uy1 = bias(y1) - 1u;
+
+    for (uint32_t ty = uy0 >> kTileShift; ty <= uy1 >> kTileShift; ++ty) {
+        const uint32_t cy0 = ty == uy0 >> kTileShift ? uy0 & m : 0;
+        const uint32_t cy1 = ty == uy1 >> kTileShift ? uy1 & m : m;
+        for (uint32_t tx = ux0 >> kTileShift; tx <= ux1 >> kTileShift; ++tx) {
+            const uint32_t cx0 = tx == ux0 >> kTileShift ? ux0 & m : 0;
+            const uint32_t cx1 = tx == ux1 >> kTileShift ? ux1 & m : m;
+            const Tile& t = tile(tx, ty);
+            const float* v = t.value[ri].data();
+            auto consider = [&](uint32_t i) {
+                if (v[i] > best.richness) {
+                    best = Site{unbias(tx << kTileShift | (i & m)), unbias(ty << kTileShift | (i >> kTileShift)), v[i]};
+                }
+            };
+            if (cx0 == 0 && cy0 == 0 && cx1 == m && cy1 == m) {
+                consider(t.best[ri]);
+                continue;
+            }
+            for (uint32_t cy = cy0; cy <= cy1; ++cy) {
+                for (uint32_t cx = cx0; cx <= cx1; ++cx) consider(cy * kTileSize + cx);
+            }
+        }
+    }
+    return best;
+}
+
+const Field::Tile& Field::tile(uint32_t tx, uint32_t ty) {
+    const uint64_t key = static_cast<uint64_t>(tx) << 32 | ty;
+    const auto it = index_.find(key);
+    if (it != index_.end()) {
+        ++stats_.hits;
+        if (it->second != head_) {
+            unlink(it->second);
+            pushFront(it->second);
+        }
+        return tiles_[it->second];
+    }
+
+    ++stats_.misses;
+    uint32_t i;
+    if (tiles_.size() < maxTiles_) {
+        i = static_cast<uint32_t>(tiles_.size());
+        tiles_.emplace_back();
+        for (auto& v : tiles_[i].value) v.resize(kTileCells);
+    } else {
+        i = tail_;
+        unlink(i);
+        index_.erase(tiles_[i].key);
+        ++stats_.evictions;
+    }
+    Tile& t = tiles_[i];
+    t.key = key;
+    generate(t, tx, ty);
+    index_.emplace(key, i);
+    pushFront(i);
+    return t;
+}
+
+void Field::generate(Tile& t, uint32_t tx, uint32_t ty) const {
+    for (int ri = 0; ri < static_cast<int>(Resource::COUNT); ++ri) {
+        const Plan pl = plan(params_, static_cast<Resource>(ri));
+        float* v = t.value[ri].data();
+        for (uint32_t cy = 0; cy < static_cast<uint32_t>(kTileSize); ++cy) {
+            fill_row(pl, tx << kTileShift, ty << kTileShift | cy, kTileSize, v + cy * kTileSize);
+        }
+        uint32_t best = 0;
+        for (uint32_t i = 1; i < kTileCells; ++i) {
+            if (v[i] > v[best]) best = i;
+        }
+        t.best[ri] = best;
+    }
+}
+
+void Field::unlink(uint32_t i) {
+    Tile& t = tiles_[i];
+    (t.prev == kNil ? head_ : tiles_[t.prev].next) = t.next;
+    (t.next == kNil ? tail_ : tiles_[t.next].prev) = t.prev;
+}
+
+void Field::pushFront(uint32_t i) {
+    Tile& t = tiles_[i];
+    t.prev = kNil;
+    t.next = head_;
+    (head_ == kNil ? tail_ : tiles_[head_].prev) = i;
+    head_ = i;
+}
+
+} // namespace mars::deposits
@@ -0,0 +1,90 @@
+// src/systems/deposits.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Where the ground holds ice and metals. Richness at a map cell is a pure
+// function of the world seed: a few octaves of value noise on an integer
+// lattice hash, cut off below a floor so deposits come in patches.
+//
+// sample() is the scalar definition. Field evaluates whole rows four
+// cells at a time (SSE2 where available) and keeps 64x64-cell tiles in an
+// LRU cache; the SIMD lanes do the scalar float operations in the same
+// order, so cached values equal sample() bit for bit as long as the
+// compiler doesn't contract the scalar path into FMAs.
+
+namespace mars::deposits {
+
+enum class Resource : uint8_t { Ice, Metals, COUNT };
+
+struct Params {
+    uint32_t seed        = 0;
+    int      octaves     = 4;      // each halves the lattice spacing
+    int      baseShift   = 6;      // octave 0 spacing, log2 cells; octaves <= baseShift + 1
+    float    iceFloor    = 0.50f;  // noise below the floor is barren
+    float    metalsFloor = 0.60f;
+};
+
+// Richness in [0, 1) of cell (x, y).
+float sample(const Params& p, Resource r, int32_t x, int32_t y);
+
+// Cells (x0 + i, y) for i < n into out[i].
+void sample_row(const Params& p, Resource r, int32_t x0, int32_t y, std::size_t n, float* out);
+
+struct Site {
+    int32_t x = 0, y = 0;
+    float   richness = -1.0f;  // < 0: empty search area
+};
+
+class Field {
+public:
+    static constexpr int         kTileShift = 6;
+    static constexpr int32_t     kTileSize  = 1 << kTileShift;
+    static constexpr std::size_t kTileCells = std::size_t(kTileSize) * kTileSize;
+
+    struct Stats {
+        uint64_t hits = 0, misses = 0, evictions = 0;
+    };
+
+    explicit Field(const Params& p = Params{}, std::size_t maxTiles = 256);
+
+    // A different world: drops every cached tile.
+    void reset(const Params& p);
+
+    const Params& params() const { return params_; }
+    const Stats&  stats() const { return stats_; }
+    std::size_t   cachedTiles() const { return tiles_.size(); }
+
+    float richness(Resource r, int32_t x, int32_t y);
+
+    // Richest cell in [x0, x1) x [y0, y1); ties go to the first cell in
+    // tile-major, then row-major order. Tiles the area covers entirely are
+    // answered from the maximum recorded when the tile was generated.
+    Site best_site(Resource r, int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Tile {
+        uint64_t key;
+        std::vector<float> value[2];  // per resource, row-major
+        uint32_t best[2];             // index of the first maximum
+        uint32_t prev, next;          // LRU list, head = most recent
+    };
+
+    const Tile& tile(uint32_t tx, uint32_t ty);  // biased tile coordinates
+    void generate(Tile& t, uint32_t tx, uint32_t ty) const;
+    void unlink(uint32_t i);
+    void pushFront(uint32_t i);
+
+    Params                                 params_;
+    std::size_t                            maxTiles_;
+    std::vector<Tile>                      tiles_;
+    std::unordered_map<uint64_t, uint32_t> index_;
+    uint32_t                               head_ = kNil, tail_ = kNil;
+    Stats                                  stats_;
+};
+
+} // namespace mars::deposits
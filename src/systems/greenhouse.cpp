@@ -0,0 +1,153 @@
+// src/systems/greenhouse.cpp
+#include "greenhouse.h"
+#include <algorithm>
+#include <cmath>
+
+namespace mars::greenhouse {
+
+namespace {
+
+// Plot state during a tick; P and U start at 0 and end as the tick's totals.
+struct Y {
+    double b, w, p, u;
+};
+
+// Per-tick constants of the right-hand side.
+struct Coef {
+    double rfg;      // r·f(I)·g(C)
+    double kf;       // k·f(I)
+    double q;
+    double invBmax, invWcap, kw, m;
+};
+
+inline Coef coef(double light, double irrigation, const Env& env, const Params& p) {
+    const double I  = light * env.lightScale;
+    const double fI = I / (I + p.lightHalfSat);
+    const double gC = env.co2Ppm / (env.co2Ppm + p.co2HalfSatPpm);
+    return Coef{p.growthPerHour * fI * gC, p.transpLPerKgH * fI, irrigation * env.irrigationScale,
+                1.0 / p.maxBiomassKg, 1.0 / p.fieldCapacityL, p.waterHalfSatL, p.maintenance};
+}
+
+// Stage states can dip below zero; the responses see them clamped.
+inline Y rhs(const Y& y, const Coef& c) {
+    const double b = std::max(y.b, 0.0);
+    const double w = std::max(y.w, 0.0);
+    const double hW = w / (w + c.kw);
+    const double growth = c.rfg * hW * b * (1.0 - b * c.invBmax);
+    const double inflow = c.q * (1.0 - y.w * c.invWcap);
+    return Y{growth - c.m * b, inflow - c.kf * b * hW, growth, inflow};
+}
+
+inline Y axpy(const Y& y, double h, const Y& k) {
+    return Y{y.b + h * k.b, y.w + h * k.w, y.p + h * k.p, y.u + h * k.u};
+}
+
+// One Bogacki–Shampine 3(2) step of size h. Returns the 3rd-order solution
+// and sets `err` to the larger embedded error of the B and W components.
+// Branch-free, so a loop of calls over lanes vectorises.
+inline Y attempt(const Y& y, double h, const Coef& c, double& err) {
+    const Y k1 = rhs(y, c);
+    const Y k2 = rhs(axpy(y, 0.5 * h, k1), c);
+    const Y k3 = rhs(axpy(y, 0.75 * h, k2), c);
+    const double a1 = h * (2.0 / 9.0), a2 = h * (1.0 / 3.0), a3 = h * (4.0 / 9.0);
+    const Y y3{y.b + a1 * k1.b + a2 * k2.b + a3 * k3.b,
+               y.w + a1 * k1.w + a2 * k2.w + a3 * k3.w,
+               y.p + a1 * k1.p + a2 * k2.p + a3 * k3.p,
+               y.u + a1 * k1.u + a2 * k2.u + a3 * k3.u};
+    const Y k4 = rhs(y3, c);
+    // y3 - y2, with y2 the embedded 2nd-order solution.
+    const double e1 = h * (2.0 / 9.0 - 7.0 / 24.0), e2 = h * (1.0 / 3.0 - 1.0 / 4.0),
+                 e3 = h * (4.0 / 9.0 - 1.0 / 3.0), e4 = h * (-1.0 / 8.0);
+    const double eb = e1 * k1.b + e2 * k2.b + e3 * k3.b + e4 * k4.b;
+    const double ew = e1 * k1.w + e2 * k2.w + e3 * k3.w + e4 * k4.w;
+    err = std::max(std::fabs(eb), std::fabs(ew));
+    return y3;
+}
+
+// Clamps, harvests and books one plot's finished tick.
+inline void finish(const Y& y, double& biomassKg, double& waterL, const Params& p, Totals& out) {
+    double b = std::max(y.b, 0.0);
+    if (b >= p.harvestAtKg) {
+        out.harvestKg += b - p.seedKg;
+        b = p.seedKg;
+    }
+    biomassKg = b;
+    waterL    = std::max(y.w, 0.0);
+    out.o2Kg   += p.o2PerKg * y.p;
+    out.waterL += y.u;
+}
+
+constexpr std::size_t kBlock = 8;
+
+} // namespace
+
+void step(double& biomassKg, double& waterL, double light, double irrigationLPerH,
+          const Env& env, const Params& p, Totals& out) {
+    const Coef c = coef(light, irrigationLPerH, env, p);
+    const double dt   = env.dtHours;
+    const double hMin = dt / p.maxSubsteps;
+    Y y{biomassKg, waterL, 0.0, 0.0};
+
+    double err = 0.0;
+    const Y whole = attempt(y, dt, c, err);
+    if (err <= p.tolerance) {
+        finish(whole, biomassKg, waterL, p, out);
+        return;
+    }
+
+    // Stiff: sub-step with the usual 3rd-order controller, starting from
+    // what the failed attempt suggests. Steps at hMin are taken regardless,
+    // which bounds the work per tick.
+    ++out.stiffPlots;
+    double t = 0.0;
+    double h = std::max(hMin, dt * std::max(0.2, 0.9 * std::cbrt(p.tolerance / err)));
+    while (t < dt) {
+        h = std::min(h, dt - t);
+        const Y next = attempt(y, h, c, err);
+        const double grow = err > 0.0 ? 0.9 * std::cbrt(p.tolerance / err) : 5.0;
+        if (err <= p.tolerance || h <= hMin) {
+            y = next;
+            t += h;
+            ++out.substeps;
+            h *= std::min(5.0, std::max(0.2, grow));
+        } else {
+            h *= std::max(0.2, grow);
+        }
+        h = std::max(h, hMin);
+    }
+    finish(y, biomassKg, waterL, p, out);
+}
+
+Totals step_batch(std::size_t n, const PlotsSoA& plots, const Env& env, const Params& p) {
+    Totals out;
+    const double dt = env.dtHours;
+    // Lane results, one array per component.
+    double yb[kBlock], yw[kBlock], yp[kBlock], yu[kBlock], err[kBlock];
+
+    for (std::size_t base = 0; base < n; base += kBlock) {
+        const std::size_t m = std::min(kBlock, n - base);
+        // The same straight-line step for every lane.
+        for (std::size_t l = 0; l < m; ++l) {
+            const std::size_t i = base + l;
+            const Coef c = coef(plots.light[i], plots.irrigationLPerH[i], env, p);
+            const Y y = attempt(Y{plots.biomassKg[i], plots.waterL[i], 0.0, 0.0}, dt, c, err[l]);
+            yb[l] = y.b;
+            yw[l] = y.w;
+            yp[l] = y.p;
+            yu[l] = y.u;
+        }
+        // In lane order, so the totals add up exactly as per-plot step() calls would.
+        for (std::size_t l = 0; l < m; ++l) {
+            const std::size_t i = base + l;
+            if (err[l] <= p.tolerance) {
+                finish(Y{yb[l], yw[l], yp[l], yu[l]}, plots.biomassKg[i], plots.waterL[i], p, out);
+            } else {
+                step(plots.biomassKg[i], plots.waterL[i], plots.light[i], plots.irrigationLPerH[i],
+                     env, p, out);
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace mars::greenhouse
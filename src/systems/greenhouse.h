@@ -0,0 +1,80 @@
+// src/systems/greenhouse.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Crop growth per greenhouse plot. Each plot is a small ODE in four states:
+//
+//   dB/dt = r·f(I)·g(C)·h(W)·B·(1 - B/Bmax) - m·B      biomass [kg]
+//   dW/dt = q·(1 - W/Wcap) - k·B·f(I)·h(W)              soil water [L]
+//   dP/dt = r·f(I)·g(C)·h(W)·B·(1 - B/Bmax)            gross growth [kg]
+//   dU/dt = q·(1 - W/Wcap)                              water drawn [L]
+//
+// with saturating light, CO2 and water responses f, g, h = x / (x + K).
+// P and U only accumulate; they turn into O2 produced and water drawn from
+// the colony over the step.
+//
+// Transpiration makes W stiff once a large crop has dried the soil out
+// (dh/dW is steep near 0), so a fixed explicit step blows up exactly
+// there. The integrator is Bogacki–Shampine 3(2): the batch path takes
+// one step per plot per tick and keeps it when the embedded error is
+// within tolerance; only the plots that fail are redone with adaptive
+// sub-steps.
+
+namespace mars::greenhouse {
+
+struct Params {
+    double growthPerHour   = 0.02;    // r
+    double maxBiomassKg    = 20.0;    // Bmax
+    double maintenance     = 0.001;   // m, per hour
+    double lightHalfSat    = 0.3;     // K for relative light (1 = full lamps)
+    double co2HalfSatPpm   = 400.0;   // K for CO2
+    double waterHalfSatL   = 0.5;     // K for soil water
+    double fieldCapacityL  = 10.0;    // Wcap
+    double transpLPerKgH   = 0.05;    // k
+    double o2PerKg         = 1.07;    // kg O2 per kg gross growth (32/30)
+    double harvestAtKg     = 15.0;    // cut back to seedKg when reached
+    double seedKg          = 0.5;
+    double tolerance       = 1e-4;    // max embedded error per step (kg or L)
+    int    maxSubsteps     = 256;     // per plot per tick
+};
+
+struct Env {
+    double co2Ppm     = 1000.0;  // habitat air
+    double dtHours    = 1.0;
+    double lightScale = 1.0;     // lamp power, scales every plot's light
+    double irrigationScale = 1.0;  // share of each plot's q the colony can supply
+};
+
+// Plot i's state and inputs; all arrays hold `n` elements.
+struct PlotsSoA {
+    double*       biomassKg;
+    double*       waterL;
+    const double* light;              // 0..1
+    const double* irrigationLPerH;    // q
+};
+
+// Colony-level effect of one tick, summed over plots.
+struct Totals {
+    double      o2Kg       = 0.0;
+    double      waterL     = 0.0;
+    double      harvestKg  = 0.0;
+    std::size_t stiffPlots = 0;   // plots that needed sub-steps
+    std::size_t substeps   = 0;   // sub-steps taken by those plots
+};
+
+// One plot, fully adaptive: sub-steps until each meets the tolerance.
+// The reference the batch path is checked against.
+void step(double& biomassKg, double& waterL, double light, double irrigationLPerH,
+          const Env& env, const Params& p, Totals& out);
+
+// All plots. Lanes are integrated in fixed-width blocks: one branch-free
+// loop over the lanes writes each state component to its own array, so the
+// compiler can vectorise it (GCC does at -O3; at -O2 it stays scalar, with
+// the same results). A lane whose single step is accepted gets exactly the
+// arithmetic step() does for its first attempt, and a rejected lane is
+// handed to step() from its original state. Results therefore match step()
+// per plot bit for bit.
+Totals step_batch(std::size_t n, const PlotsSoA& plots, const Env& env, const Params& p);
+
+} // namespace mars::greenhouse
@@ -1,32 +1,41 @@
 // src/systems/power_system.cpp
 #include "power_system.h"
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define MARS_POWER_SSE2 1
+#endif
 
 namespace mars::power {
 
-State step(State s, const Inputs& in, const Config& cfg, Result& out) {
+template <class T>
+BasicState<T> step(BasicState<T> s, const BasicInputs<T>& in, const BasicConfig<T>& cfg, BasicResult<T>& out) {
+    const T zero = Scalar<T>::zero();
+
     // Convert W -> Wh for the tick
-    const double prodWh   = in.producersW       * in.dtHours;
-    const double critWh   = in.criticalDemandW  * in.dtHours;
-    const double nonCritWh= in.nonCriticalDemandW * in.dtHours;
+    const T prodWh   = in.producersW       * in.dtHours;
+    const T critWh   = in.criticalDemandW  * in.dtHours;
+    const T nonCritWh= in.nonCriticalDemandW * in.dtHours;
 
     // C-rate limits for this step
-    const double maxInWh  = cfg.cRate * s.capacityWh * in.dtHours;
-    const double maxOutWh = cfg.cRate * s.capacityWh * in.dtHours;
+    const T maxInWh  = cfg.cRate * s.capacityWh * in.dtHours;
+    const T maxOutWh = cfg.cRate * s.capacityWh * in.dtHours;
 
-    double battInWh  = 0.0;
-    double battOutWh = 0.0;
+    T battInWh  = zero;
+    T battOutWh = zero;
 
     // Serve critical first: use producers, then discharge battery
-    double availableWh = prodWh;
-    double unmetCriticalWh = 0.0;
+    T availableWh = prodWh;
+    T unmetCriticalWh = zero;
 
     if (availableWh >= critWh) {
         availableWh -= critWh; // critical fully served
     } else {
         // Need discharge
-        double needWh = critWh - availableWh;
+        T needWh = critWh - availableWh;
         // Due to discharge efficiency, we must draw more from the pack
-        double drawWh = std::min({ needWh / cfg.etaOut, maxOutWh, s.storedWh });
+        T drawWh = std::min({ needWh / cfg.etaOut, maxOutWh, s.storedWh });
         battOutWh = drawWh;
         availableWh += drawWh * cfg.etaOut;
 
@@ -35,24 +44,24 @@ State step(State s, const Inputs& in, const Config& cfg, Result& out) {
         } else {
             // Even after max discharge, still not enough
             unmetCriticalWh = critWh - availableWh;
-            availableWh = 0.0;
+            availableWh = zero;
         }
     }
 
     // Non-critical: whatever remains charges nonCritical, possibly scale
-    double serveNonCritWh = std::min(availableWh, nonCritWh);
-    double nonCritEff = (nonCritWh > 0.0) ? clamp01(serveNonCritWh / nonCritWh) : 1.0;
+    T serveNonCritWh = std::min(availableWh, nonCritWh);
+    T nonCritEff = (nonCritWh > zero) ? clamp01(serveNonCritWh / nonCritWh) : Scalar<T>::one();
 
     // If producers exceed all demand, try to charge battery with the spare
-    double spareWh = availableWh - serveNonCritWh;
-    if (spareWh > 1e-12) {
+    T spareWh = availableWh - serveNonCritWh;
+    if (spareWh > Scalar<T>::chargeMin()) {
         // Account for charge efficiency: to store X, we must input X/etaIn from spare
         // But we are limited by capacity room and C-rate.
-        const double roomWh = std::max(0.0, s.capacityWh - s.storedWh);
+        const T roomWh = std::max(zero, s.capacityWh - s.storedWh);
         // Energy that can actually be stored this step:
-        double storeWh = std::min({ spareWh * cfg.etaIn, roomWh, maxInWh * cfg.etaIn });
+        T storeWh = std::min({ spareWh * cfg.etaIn, roomWh, maxInWh * cfg.etaIn });
         // Convert stored energy back to input used from spare
-        double usedSpareWh = storeWh / cfg.etaIn;
+        T usedSpareWh = storeWh / cfg.etaIn;
         // If rounding pushed beyond spare, clamp
         storeWh = std::min(storeWh, spareWh * cfg.etaIn);
         battInWh = storeWh; // actual stored energy
@@ -60,7 +69,7 @@ State step(State s, const Inputs& in, const Config& cfg, Result& out) {
     }
 
     // Update SoC with saturating math
-    s.storedWh = saturate(s.storedWh + battInWh - battOutWh, 0.0, s.capacityWh);
+    s.storedWh = saturate(s.storedWh + battInWh - battOutWh, zero, s.capacityWh);
 
     out.nonCriticalEff   = clamp01(nonCritEff);
     out.battInWh         = battInWh;
@@ -69,4 +78,289 @@ State step(State s, const Inputs& in, const Config& cfg, Result& out) {
     return s;
 }
 
+template BasicState<double> step(BasicState<double>, const BasicInputs<double>&, const BasicConfig<double>&, BasicResult<double>&);
+template BasicState<FP>     step(BasicState<FP>, const BasicInputs<FP>&, const BasicConfig<FP>&, BasicResult<FP>&);
+
+// Per-step flows in the linear regime, using step()'s own expressions with the
+// pack neither empty nor full. A step leaves the regime when stored < drawWh
+// (discharging) or the room < storeWh (charging).
+struct Regime {
+    bool   discharging = false;
+    double drawWh      = 0.0;
+    bool   charging    = false;
+    double storeWh     = 0.0;
+    bool   cRateLimited = false;
+};
+
+static Regime regime(double capacityWh, const Inputs& in, const Config& cfg) {
+    const double prodWh   = in.producersW       * in.dtHours;
+    const double critWh   = in.criticalDemandW  * in.dtHours;
+    const double nonCritWh= in.nonCriticalDemandW * in.dtHours;
+    const double maxInWh  = cfg.cRate * capacityWh * in.dtHours;
+    const double maxOutWh = cfg.cRate * capacityWh * in.dtHours;
+
+    Regime g;
+    double availableWh = prodWh;
+    if (availableWh >= critWh) {
+        availableWh -= critWh;
+    } else {
+        g.discharging = true;
+        const double wantWh = (critWh - availableWh) / cfg.etaOut;
+        g.drawWh = std::min(wantWh, maxOutWh);
+        g.cRateLimited = maxOutWh < wantWh;
+        availableWh += g.drawWh * cfg.etaOut;
+        availableWh = (availableWh >= critWh) ? availableWh - critWh : 0.0;
+    }
+    const double spareWh = availableWh - std::min(availableWh, nonCritWh);
+    if (spareWh > 1e-12) {
+        g.charging = true;
+        g.storeWh = std::min(spareWh * cfg.etaIn, maxInWh * cfg.etaIn);
+        g.cRateLimited = g.cRateLimited || maxInWh * cfg.etaIn < spareWh * cfg.etaIn;
+    }
+    return g;
+}
+
+// Up to k in-regime steps of step()'s update x <- (x + a) - b, rounded as
+// step() rounds them; returns how many were taken. Inside one binade
+// [lo, 2·lo) every double is a multiple of u = ulp(lo), so while x, x + a
+// and the result stay in it each step moves x by the same multiple of u
+// and m steps are one integer product. Stops at the binade's edge, a few
+// steps short of the pack limiting a flow, and on a rounding tie (the step
+// would depend on x's last bit); the caller takes a real step there.
+static std::uint64_t progress(double& x, double a, double b, const Regime& g, double capacityWh,
+                              std::uint64_t k) {
+    if (!(x >= std::numeric_limits<double>::min() && x <= std::numeric_limits<double>::max())) return 0;
+    constexpr std::int64_t kSpan = std::int64_t{1} << 52;   // binade width in u
+    int e;
+    std::frexp(x, &e);                                       // x in [2^(e-1), 2^e)
+    const double lo = std::ldexp(1.0, e - 1);
+    const double u  = std::ldexp(1.0, e - 53);
+    const double qa = a / u, qb = b / u;                     // exact: u is a power of two
+    if (!(qa < kSpan && qb < kSpan)) return 0;
+    if (qa - std::floor(qa) == 0.5 || qb - std::floor(qb) == 0.5) return 0;
+    const std::int64_t ra = static_cast<std::int64_t>(std::nearbyint(qa));
+    const std::int64_t rb = static_cast<std::int64_t>(std::nearbyint(qb));
+    const std::int64_t X  = static_cast<std::int64_t>((x - lo) / u);
+    const std::int64_t D  = ra - rb;
+
+    // x + a must land below 2·lo (the largest sum is the first unless x
+    // rises) and every result at or above lo + u.
+    if (X + ra > kSpan - 1) return 0;
+    std::int64_t m = static_cast<std::int64_t>(std::min<std::uint64_t>(k, kSpan));
+    if (D > 0) m = std::min(m, (kSpan - 1 - ra - X) / D + 1);
+    if (D < 0) m = std::min(m, (X - 1) / -D);
+
+    // Steps before the pack would limit a flow, less a margin for the
+    // rounding in this estimate and in step()'s own comparisons.
+    const double stepWh = static_cast<double>(D) * u;
+    const bool empties = g.discharging && D < 0, fills = g.charging && D > 0;
+    if (empties || fills) {
+        const double until = empties ? (x - g.drawWh) / -stepWh : (capacityWh - g.storeWh - x) / stepWh;
+        if (!(until >= 5.0)) return 0;                       // also catches NaN
+        m = std::min(m, static_cast<std::int64_t>(std::min(until, 0x1p62)) - 4);
+    }
+    if (m <= 0) return 0;
+
+    x = lo + static_cast<double>(X + m * D) * u;
+    return static_cast<std::uint64_t>(m);
+}
+
+MultiStepResult step_n(State s, const Inputs& in, const Config& cfg, std::uint64_t n) {
+    MultiStepResult r;
+    r.state = s;
+    if (n == 0) return r;
+
+    const Regime g = regime(s.capacityWh, in, cfg);
+    r.cRateLimited = g.cRateLimited;
+
+    std::uint64_t done = 0;
+    while (done < n) {
+        // One real step, noting whether the pack limited it.
+        const double x = r.state.storedWh;
+        Crossing hit = Crossing::None;
+        if (g.discharging && x < g.drawWh) hit = Crossing::Empty;
+        else if (g.charging && std::max(0.0, r.state.capacityWh - x) < g.storeWh) hit = Crossing::Full;
+
+        Result one;
+        r.state = step(r.state, in, cfg, one);
+        ++done;
+        r.last = one;
+        r.battInWh        += one.battInWh;
+        r.battOutWh       += one.battOutWh;
+        r.unmetCriticalWh += one.unmetCriticalWh;
+        if (hit != Crossing::None && r.crossing == Crossing::None) {
+            r.crossing = hit;
+            r.crossingStep = done;
+        }
+
+        const std::uint64_t left = n - done;
+        if (left == 0) break;
+        const double next  = r.state.storedWh;
+        const double delta = next - x;
+
+        // Steady (empty, full or balanced): every remaining step is this one.
+        if (delta == 0.0) {
+            const double k = static_cast<double>(left);
+            r.battInWh        += k * one.battInWh;
+            r.battOutWh       += k * one.battOutWh;
+            r.unmetCriticalWh += k * one.unmetCriticalWh;
+            break;
+        }
+        if (hit != Crossing::None) continue;   // settle with real steps
+
+        const std::uint64_t jump = progress(r.state.storedWh, one.battInWh, one.battOutWh, g,
+                                            r.state.capacityWh, left);
+        const double k = static_cast<double>(jump);
+        r.battInWh        += k * one.battInWh;
+        r.battOutWh       += k * one.battOutWh;
+        r.unmetCriticalWh += k * one.unmetCriticalWh;
+        done += jump;
+    }
+    return r;
+}
+
+static void step_lane(std::size_t i, const StateSoA& s, const InputsSoA& in,
+                      const Config& cfg, const ResultSoA& out) {
+    Result r;
+    const State next = step(State{s.storedWh[i], s.capacityWh[i]},
+                            Inputs{in.producersW[i], in.criticalDemandW[i],
+                                   in.nonCriticalDemandW[i], in.dtHours[i]},
+                            cfg, r);
+    s.storedWh[i]          = next.storedWh;
+    out.nonCriticalEff[i]  = r.nonCriticalEff;
+    out.battInWh[i]        = r.battInWh;
+    out.battOutWh[i]       = r.battOutWh;
+    out.unmetCriticalWh[i] = r.unmetCriticalWh;
+}
+
+#ifdef MARS_POWER_SSE2
+// MINPD/MAXPD return their second operand unless the first compares strictly
+// less/greater, so std::min(a, b) == min(b, a) and std::max(a, b) == max(b, a).
+static inline __m128d vmin(__m128d a, __m128d b) { return _mm_min_pd(b, a); }
+static inline __m128d vmax(__m128d a, __m128d b) { return _mm_max_pd(b, a); }
+static inline __m128d select(__m128d mask, __m128d a, __m128d b) {
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+// Both branches of every `if` in step() are computed and blended by mask.
+static void step_pair(std::size_t i, const StateSoA& s, const InputsSoA& in,
+                      const Config& cfg, const ResultSoA& out) {
+    const __m128d zero   = _mm_setzero_pd();
+    const __m128d one    = _mm_set1_pd(1.0);
+    const __m128d etaIn  = _mm_set1_pd(cfg.etaIn);
+    const __m128d etaOut = _mm_set1_pd(cfg.etaOut);
+    const __m128d cRate  = _mm_set1_pd(cfg.cRate);
+
+    const __m128d stored = _mm_loadu_pd(s.storedWh + i);
+    const __m128d cap    = _mm_loadu_pd(s.capacityWh + i);
+    const __m128d dt     = _mm_loadu_pd(in.dtHours + i);
+
+    const __m128d prodWh    = _mm_mul_pd(_mm_loadu_pd(in.producersW + i), dt);
+    const __m128d critWh    = _mm_mul_pd(_mm_loadu_pd(in.criticalDemandW + i), dt);
+    const __m128d nonCritWh = _mm_mul_pd(_mm_loadu_pd(in.nonCriticalDemandW + i), dt);
+    const __m128d maxWh     = _mm_mul_pd(_mm_mul_pd(cRate, cap), dt);   // in == out
+
+    // Critical: producers first, then discharge.
+    const __m128d covered  = _mm_cmpge_pd(prodWh, critWh);
+    __m128d drawWh = _mm_div_pd(_mm_sub_pd(critWh, prodWh), etaOut);
+    drawWh = vmin(drawWh, maxWh);
+    drawWh = vmin(drawWh, stored);
+    const __m128d afterDraw = _mm_add_pd(prodWh, _mm_mul_pd(drawWh, etaOut));
+    const __m128d enough    = _mm_cmpge_pd(afterDraw, critWh);
+
+    const __m128d battOutWh = select(covered, zero, drawWh);
+    const __m128d availableWh = select(covered, _mm_sub_pd(prodWh, critWh),
+                                       select(enough, _mm_sub_pd(afterDraw, critWh), zero));
+    const __m128d unmetWh = select(covered, zero,
+                                   select(enough, zero, _mm_sub_pd(critWh, afterDraw)));
+
+    // Non-critical from what is left.
+    const __m128d serveWh = vmin(availableWh, nonCritWh);
+    const __m128d hasNonCrit = _mm_cmpgt_pd(nonCritWh, zero);
+    const __m128d effRaw = vmax(zero, vmin(one, _mm_div_pd(serveWh, nonCritWh)));
+    const __m128d eff = select(hasNonCrit, effRaw, one);
+
+    // Charge with the spare.
+    const __m128d spareWh  = _mm_sub_pd(availableWh, serveWh);
+    const __m128d charging = _mm_cmpgt_pd(spareWh, _mm_set1_pd(1e-12));
+    const __m128d roomWh   = vmax(zero, _mm_sub_pd(cap, stored));
+    const __m128d spareIn  = _mm_mul_pd(spareWh, etaIn);
+    __m128d storeWh = vmin(spareIn, roomWh);
+    storeWh = vmin(storeWh, _mm_mul_pd(maxWh, etaIn));
+    storeWh = vmin(storeWh, spareIn);
+    const __m128d battInWh = select(charging, storeWh, zero);
+
+    const __m128d next = vmax(zero, vmin(cap, _mm_sub_pd(_mm_add_pd(stored, battInWh), battOutWh)));
+
+    _mm_storeu_pd(s.storedWh + i, next);
+    _mm_storeu_pd(out.nonCriticalEff + i, vmax(zero, vmin(one, eff)));
+    _mm_storeu_pd(out.battInWh + i, battInWh);
+    _mm_storeu_pd(out.battOutWh + i, battOutWh);
+    _mm_storeu_pd(out.unmetCriticalWh + i, unmetWh);
+}
+#endif
+
+void step_batch(std::size_t n, const StateSoA& s, const InputsSoA& in,
+                const Config& cfg, const ResultSoA& out) {
+    std::size_t i = 0;
+#ifdef MARS_POWER_SSE2
+    for (; i + 2 <= n; i += 2) step_pair(i, s, in, cfg, out);
+#endif
+    for (; i < n; ++i) step_lane(i, s, in, cfg, out);
+}
+
+// FP's * and / on raw values.
+static inline std::int64_t fmul(std::int64_t a, std::int64_t b) { return FP::mul(FP{a}, FP{b}).raw; }
+static inline std::int64_t fdiv(std::int64_t a, std::int64_t b) { return FP::div(FP{a}, FP{b}).raw; }
+
+// step<FP>() with every `if` turned into a select, except around the two
+// divisions: a 64-bit divide costs more than a mispredict, so lanes that
+// don't need one skip it.
+void step_batch(std::size_t n, const BasicStateSoA<FP>& s, const BasicInputsSoA<FP>& in,
+                const FixedConfig& cfg, const BasicResultSoA<FP>& out) {
+    using R = std::int64_t;
+    const R one = FP::SCALE;
+    const R etaIn = cfg.etaIn.raw, etaOut = cfg.etaOut.raw, cRate = cfg.cRate.raw;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const R stored = s.storedWh[i].raw;
+        const R cap    = s.capacityWh[i].raw;
+        const R dt     = in.dtHours[i].raw;
+
+        const R prodWh    = fmul(in.producersW[i].raw, dt);
+        const R critWh    = fmul(in.criticalDemandW[i].raw, dt);
+        const R nonCritWh = fmul(in.nonCriticalDemandW[i].raw, dt);
+        const R maxWh     = fmul(fmul(cRate, cap), dt);   // in == out
+
+        // Critical: producers first, then discharge.
+        const bool covered = prodWh >= critWh;
+        const R drawWh     = covered ? 0 : std::min(std::min(fdiv(critWh - prodWh, etaOut), maxWh), stored);
+        const R afterDraw  = prodWh + fmul(drawWh, etaOut);
+        const bool enough  = afterDraw >= critWh;
+
+        const R battOutWh   = drawWh;
+        const R availableWh = covered ? prodWh - critWh : (enough ? afterDraw - critWh : 0);
+        const R unmetWh     = (covered || enough) ? 0 : critWh - afterDraw;
+
+        // Non-critical from what is left.
+        const R serveWh     = std::min(availableWh, nonCritWh);
+        const bool hasNonCrit = nonCritWh > 0;
+        const R eff = hasNonCrit ? std::max<R>(0, std::min(one, fdiv(serveWh, nonCritWh))) : one;
+
+        // Charge with the spare.
+        const R spareWh = availableWh - serveWh;
+        const R roomWh  = std::max<R>(0, cap - stored);
+        const R spareIn = fmul(spareWh, etaIn);
+        R storeWh = std::min(std::min(spareIn, roomWh), fmul(maxWh, etaIn));
+        storeWh   = std::min(storeWh, spareIn);
+        const R battInWh = spareWh > 0 ? storeWh : 0;
+
+        s.storedWh[i].raw          = std::max<R>(0, std::min(cap, stored + battInWh - battOutWh));
+        out.nonCriticalEff[i].raw  = std::max<R>(0, std::min(one, eff));
+        out.battInWh[i].raw        = battInWh;
+        out.battOutWh[i].raw       = battOutWh;
+        out.unmetCriticalWh[i].raw = unmetWh;
+    }
+}
+
 } // namespace mars::power
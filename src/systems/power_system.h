@@ -1,44 +1,151 @@
 // src/systems/power_system.h
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <algorithm>
 #include <cmath>
+#include "../../fixed_point.h"
 
 // Keep all power math in Wh for the tick (dtHours), and W for rate-like values.
 // The API is intentionally tiny and pure (no globals, no I/O).
 
 namespace mars::power {
 
-struct State {
-    double storedWh;      // current energy in battery [Wh]
-    double capacityWh;    // battery capacity [Wh]
+// Everything is templated on the scalar type T. `double` is the default;
+// `FP` (fixed_point.h) gives results that are bit-exact across compilers,
+// FMA settings and platforms, at the cost of 2^-16 resolution.
+template <class T>
+struct BasicState {
+    T storedWh;      // current energy in battery [Wh]
+    T capacityWh;    // battery capacity [Wh]
 };
 
-struct Config {
-    double etaIn;         // charge efficiency in (0,1]
-    double etaOut;        // discharge efficiency in (0,1]
-    double cRate;         // C-rate (per hour), i.e., max in/out = cRate * capacityWh per hour
+template <class T>
+struct BasicConfig {
+    T etaIn;         // charge efficiency in (0,1]
+    T etaOut;        // discharge efficiency in (0,1]
+    T cRate;         // C-rate (per hour), i.e., max in/out = cRate * capacityWh per hour
 };
 
-struct Inputs {
-    double producersW;        // instantaneous producers [W]
-    double criticalDemandW;   // must-serve demand [W]
-    double nonCriticalDemandW;// can be scaled [W]
-    double dtHours;           // time step in hours (typically 1.0)
+template <class T>
+struct BasicInputs {
+    T producersW;        // instantaneous producers [W]
+    T criticalDemandW;   // must-serve demand [W]
+    T nonCriticalDemandW;// can be scaled [W]
+    T dtHours;           // time step in hours (typically 1.0)
 };
 
-struct Result {
-    double nonCriticalEff; // scale in [0,1] actually served for nonCriticalDemand
-    double battInWh;       // energy charged during the step [Wh]
-    double battOutWh;      // energy discharged during the step [Wh]
-    double unmetCriticalWh;// unmet crit energy (should be ~0 after discharge), for diagnostics
+template <class T>
+struct BasicResult {
+    T nonCriticalEff; // scale in [0,1] actually served for nonCriticalDemand
+    T battInWh;       // energy charged during the step [Wh]
+    T battOutWh;      // energy discharged during the step [Wh]
+    T unmetCriticalWh;// unmet crit energy (should be ~0 after discharge), for diagnostics
+};
+
+using State  = BasicState<double>;
+using Config = BasicConfig<double>;
+using Inputs = BasicInputs<double>;
+using Result = BasicResult<double>;
+
+using FixedState  = BasicState<FP>;
+using FixedConfig = BasicConfig<FP>;
+using FixedInputs = BasicInputs<FP>;
+using FixedResult = BasicResult<FP>;
+
+// Constants step() needs in each scalar type.
+template <class T> struct Scalar;
+template <> struct Scalar<double> {
+    static constexpr double zero()      { return 0.0; }
+    static constexpr double one()       { return 1.0; }
+    static constexpr double chargeMin() { return 1e-12; }  // spare below this is rounding noise
+};
+template <> struct Scalar<FP> {
+    static constexpr FP zero()      { return FP{0}; }
+    static constexpr FP one()       { return FP{FP::SCALE}; }
+    static constexpr FP chargeMin() { return FP{0}; }      // integers have no noise
 };
 
 // Saturating helpers
-inline double clamp01(double x) { return std::max(0.0, std::min(1.0, x)); }
-inline double saturate(double x, double lo, double hi) { return std::max(lo, std::min(hi, x)); }
+template <class T> inline T clamp01(T x) { return std::max(Scalar<T>::zero(), std::min(Scalar<T>::one(), x)); }
+template <class T> inline T saturate(T x, T lo, T hi) { return std::max(lo, std::min(hi, x)); }
 
 // One deterministic step. Pure function: returns new State and fills Result.
-State step(State s, const Inputs& in, const Config& cfg, Result& out);
+// Instantiated for double and FP.
+template <class T>
+BasicState<T> step(BasicState<T> s, const BasicInputs<T>& in, const BasicConfig<T>& cfg, BasicResult<T>& out);
+
+// Where a multi-step run stopped being linear.
+enum class Crossing : std::uint8_t {
+    None,    // the pack never limited a flow within the n steps
+    Empty,   // discharge was cut short by the stored energy
+    Full,    // charging was cut short by the remaining room
+};
+
+struct MultiStepResult {
+    State         state;              // after n steps
+    Result        last;               // flows of the final step
+    double        battInWh   = 0.0;   // totals over the n steps
+    double        battOutWh  = 0.0;
+    double        unmetCriticalWh = 0.0;
+    bool          cRateLimited = false; // the C-rate capped charge or discharge
+    Crossing      crossing   = Crossing::None;
+    std::uint64_t crossingStep = 0;     // 1-based step where `crossing` first happened
+};
+
+// n steps of step() with the same Inputs, in O(1) scalar steps per regime.
+//
+// With constant inputs every flow is constant until the pack runs empty or
+// full, so stored energy moves by a fixed amount per step. Rounded, that
+// amount is a fixed multiple of the ulp while the stored energy stays in one
+// binade, so the run jumps a binade at a time with one integer product and
+// lands on the double that iterating step() reaches. Jumps stop a few steps
+// short of the predicted crossing, and real steps find it with the same
+// comparisons step() makes: the state and crossing step match iterating
+// exactly; the totals round once per jump rather than once per step.
+MultiStepResult step_n(State s, const Inputs& in, const Config& cfg, std::uint64_t n);
+
+// Structure-of-arrays views for stepping many independent batteries at once.
+// Lane i of each array belongs to battery i; all arrays hold `n` elements.
+template <class T>
+struct BasicStateSoA {
+    T* storedWh;
+    T* capacityWh;   // read-only here; battery wear fades it
+};
+
+template <class T>
+struct BasicInputsSoA {
+    const T* producersW;
+    const T* criticalDemandW;
+    const T* nonCriticalDemandW;
+    const T* dtHours;
+};
+
+template <class T>
+struct BasicResultSoA {
+    T* nonCriticalEff;
+    T* battInWh;
+    T* battOutWh;
+    T* unmetCriticalWh;
+};
+
+using StateSoA  = BasicStateSoA<double>;
+using InputsSoA = BasicInputsSoA<double>;
+using ResultSoA = BasicResultSoA<double>;
+
+// step() for n batteries sharing one Config, updating storedWh in place.
+// Lane results are bitwise identical to calling step() per battery: the SIMD
+// path does the same operations in the same order, and its min/max operand
+// order reproduces std::min/std::max exactly (NaNs and signed zeros included).
+// Like the rest of the sim this assumes no FP contraction (-ffp-contract=off
+// on FMA targets), which would change the scalar path alone.
+void step_batch(std::size_t n, const StateSoA& s, const InputsSoA& in,
+                const Config& cfg, const ResultSoA& out);
+
+// Fixed-point batch: integer arithmetic, so lanes match step<FP>() exactly on
+// any target. The lane body works on the raw int64 columns with selects; only
+// the two fixed/fixed divisions are guarded by a branch.
+void step_batch(std::size_t n, const BasicStateSoA<FP>& s, const BasicInputsSoA<FP>& in,
+                const FixedConfig& cfg, const BasicResultSoA<FP>& out);
 
 } // namespace mars::power
@@ -0,0 +1,148 @@
+// src/systems/reactor.cpp
+#include "reactor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace mars::reactor {
+
+namespace {
+
+// Core state during a step; e accumulates electric kWh.
+struct Y {
+    double x, r, t, e;
+};
+
+// What the rods are driven toward, and how fast.
+struct Drive {
+    double u, tau, withdraw;  // withdraw: max rate out, per hour
+};
+
+Drive drive(const Core& c, const Params& p) {
+    return c.scrammed ? Drive{1.0, p.scramTauH, 0.0} : Drive{c.rodTarget, p.rodTauH, p.rodWithdrawPerH};
+}
+
+inline Y rhs(const Y& y, const Drive& d, double cooling, double k, const Params& p) {
+    const double feedback = std::max(0.0, 1.0 - p.tempCoef * (y.t - p.refC));
+    const double xeq  = (1.0 - std::clamp(y.r, 0.0, 1.0)) * feedback;
+    const double heat = cooling * k * (y.t - p.sinkC);
+    return Y{(xeq - y.x) / p.powerTauH, std::max((d.u - y.r) / d.tau, -d.withdraw),
+             (y.x - heat) / (p.thermalTauH * k),
+             p.ratedKw * heat};
+}
+
+inline Y axpy(const Y& y, double h, const Y& k) {
+    return Y{y.x + h * k.x, y.r + h * k.r, y.t + h * k.t, y.e + h * k.e};
+}
+
+} // namespace
+
+Core steady(double rodTarget, double cooling, const Params& p) {
+    const double k = 1.0 / (p.refC - p.sinkC);
+    const double u = std::clamp(rodTarget, 0.0, 1.0);
+    const double w = 1.0 - u;
+    // c·k·d = w·(1 - a·(d - 1/k)) for d = T - Tsink.
+    const double den = cooling * k + p.tempCoef * w;
+    const double d   = den > 0.0 ? w * (1.0 + p.tempCoef / k) / den : 0.0;
+    Core c;
+    c.power     = cooling * k * d;
+    c.tempC     = p.sinkC + d;
+    c.rod       = u;
+    c.rodTarget = u;
+    c.cooling   = cooling;
+    c.settled   = true;
+    return c;
+}
+
+double output_kw(const Core& c, const Params& p) {
+    return p.ratedKw * c.cooling * (c.tempC - p.sinkC) / (p.refC - p.sinkC);
+}
+
+void command_rods(Core& c, double rodTarget) {
+    const double u = std::clamp(rodTarget, 0.0, 1.0);
+    if (u == c.rodTarget) return;
+    c.rodTarget = u;
+    if (!c.scrammed) c.settled = false;
+}
+
+void set_cooling(Core& c, double cooling) {
+    if (cooling == c.cooling) return;
+    c.cooling = cooling;
+    c.settled = false;
+}
+
+bool reset_scram(Core& c, const Params& p) {
+    if (!c.scrammed) return true;
+    if (c.tempC >= p.scramC) return false;
+    c.scrammed = false;
+    c.settled  = false;
+    return true;
+}
+
+StepStats advance(Core& c, double dtHours, const Params& p) {
+    StepStats st;
+    if (c.settled || dtHours <= 0.0) {
+        st.avgKw = output_kw(c, p);
+        return st;
+    }
+
+    const double k    = 1.0 / (p.refC - p.sinkC);
+    const double hMin = dtHours / p.maxSubsteps;
+    Drive d = drive(c, p);
+    Y y{c.power, c.rod, c.tempC, 0.0};
+    Y k1 = rhs(y, d, c.cooling, k, p);
+    double t = 0.0;
+    double h = std::min(dtHours, p.powerTauH);
+    while (t < dtHours) {
+        h = std::min(h, dtHours - t);
+        const Y k2 = rhs(axpy(y, 0.5 * h, k1), d, c.cooling, k, p);
+        const Y k3 = rhs(axpy(y, 0.75 * h, k2), d, c.cooling, k, p);
+        const double a1 = h * (2.0 / 9.0), a2 = h * (1.0 / 3.0), a3 = h * (4.0 / 9.0);
+        const Y y3{y.x + a1 * k1.x + a2 * k2.x + a3 * k3.x,
+                   y.r + a1 * k1.r + a2 * k2.r + a3 * k3.r,
+                   y.t + a1 * k1.t + a2 * k2.t + a3 * k3.t,
+                   y.e + a1 * k1.e + a2 * k2.e + a3 * k3.e};
+        const Y k4 = rhs(y3, d, c.cooling, k, p);  // k1 of the next step
+        const double e1 = h * (2.0 / 9.0 - 7.0 / 24.0), e2 = h * (1.0 / 3.0 - 1.0 / 4.0),
+                     e3 = h * (4.0 / 9.0 - 1.0 / 3.0), e4 = h * (-1.0 / 8.0);
+        const double err = std::max({std::fabs(e1 * k1.x + e2 * k2.x + e3 * k3.x + e4 * k4.x),
+                                     std::fabs(e1 * k1.r + e2 * k2.r + e3 * k3.r + e4 * k4.r),
+                                     k * std::fabs(e1 * k1.t + e2 * k2.t + e3 * k3.t + e4 * k4.t)});
+        const double grow = err > 0.0 ? 0.9 * std::cbrt(p.tolerance / err) : 5.0;
+        if (err <= p.tolerance || h <= hMin) {
+            y = y3;
+            k1 = k4;
+            t += h;
+            ++st.substeps;
+            h *= std::min(5.0, std::max(0.2, grow));
+            // Trips are checked at sub-step resolution; the rods start
+            // dropping from the state that crossed the limit.
+            if (!c.scrammed && (y.t > p.scramC || y.x > p.scramPower)) {
+                c.scrammed = true;
+                st.tripped = true;
+                d  = drive(c, p);
+                k1 = rhs(y, d, c.cooling, k, p);
+                h  = std::min(h, p.scramTauH);
+            }
+        } else {
+            h *= std::max(0.2, grow);
+        }
+        h = std::max(h, hMin);
+    }
+
+    c.power = y.x;
+    c.rod   = y.r;
+    c.tempC = y.t;
+    st.avgKw = y.e / dtHours;
+
+    const Core fixed = steady(d.u, c.cooling, p);
+    if (std::fabs(c.power - fixed.power) <= p.settleTol && std::fabs(c.rod - fixed.rod) <= p.settleTol &&
+        k * std::fabs(c.tempC - fixed.tempC) <= p.settleTol) {
+        c.power   = fixed.power;
+        c.rod     = fixed.rod;
+        c.tempC   = fixed.tempC;
+        c.settled = true;
+    }
+    return st;
+}
+
+} // namespace mars::reactor
@@ -0,0 +1,73 @@
+// src/systems/reactor.h
+#pragma once
+#include <cstddef>
+
+// Lumped reactor core: thermal power x (fraction of rated), core
+// temperature T and rod insertion r (0 = withdrawn, 1 = fully in).
+//
+//   dr/dt = max((u - r) / tauRod, -v)         u: rod target, 1 while scrammed
+//   dx/dt = (xeq - x) / tauPower              xeq = (1 - r)·(1 - a·(T - Tref))
+//   dT/dt = (x - c·k·(T - Tsink)) / (tauTh·k) k = 1 / (Tref - Tsink)
+//
+// Rods come out no faster than v, so a cold core isn't pulled into an
+// overpower trip by its temperature feedback. c is the cooling loop's
+// capacity (1 = intact); the heat it carries, c·k·(T - Tsink), drives the
+// turbine, so an intact core at r = 0 settles at Tref and rated output.
+// The negative temperature coefficient a makes every (u, c) a stable
+// fixed point, known in closed form.
+//
+// A settled core sits exactly on that fixed point and advance() returns
+// at once. Changing u or c, or a trip, starts a transient, which is
+// integrated with adaptive Bogacki–Shampine 3(2) sub-steps until the core
+// is back within settleTol of the new fixed point and snaps onto it.
+
+namespace mars::reactor {
+
+struct Params {
+    double ratedKw         = 6.0;     // electric, intact core at rated power
+    double sinkC           = 40.0;    // Tsink
+    double refC            = 320.0;   // Tref
+    double tempCoef        = 0.002;   // a, per °C
+    double powerTauH       = 0.02;
+    double rodTauH         = 0.1;
+    double rodWithdrawPerH = 0.2;     // v
+    double scramTauH       = 0.005;   // rod drop
+    double thermalTauH     = 2.0;     // tauTh
+    double scramC          = 400.0;   // trip above this core temperature
+    double scramPower      = 1.2;     // or above this thermal power
+    double tolerance       = 1e-6;    // per sub-step error: x, r and k·T
+    double settleTol       = 1e-4;    // same units, distance to the fixed point;
+                                      // must exceed the integrator's own bias
+    int    maxSubsteps     = 4096;    // per advance()
+};
+
+struct Core {
+    double power     = 0.0;   // x
+    double tempC     = 40.0;  // T
+    double rod       = 1.0;   // r
+    double rodTarget = 1.0;   // u as commanded; a scram overrides it
+    double cooling   = 1.0;   // c
+    bool   scrammed  = false;
+    bool   settled   = true;
+};
+
+struct StepStats {
+    double      avgKw    = 0.0;  // electric output averaged over the step
+    std::size_t substeps = 0;
+    bool        tripped  = false;
+};
+
+// The settled core for rod target u and cooling c.
+Core steady(double rodTarget, double cooling, const Params& p);
+
+double output_kw(const Core& c, const Params& p);
+
+// Operator inputs; each starts a transient if it moves the fixed point.
+void command_rods(Core& c, double rodTarget);
+void set_cooling(Core& c, double cooling);
+// Clears a scram once the core is back below scramC; false otherwise.
+bool reset_scram(Core& c, const Params& p);
+
+StepStats advance(Core& c, double dtHours, const Params& p);
+
+} // namespace mars::reactor
@@ -0,0 +1,125 @@
+#include "core/command.hpp"
+#include "sim/Rng.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// CommandQueue against a sorted-list model: hour order, FIFO within an hour,
+// cascades from every level (including the far-future overflow), late
+// submissions and submissions made from inside a drain.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+struct Ref { Hours due; long seq; int id; };
+
+struct Model {
+    CommandQueue q;
+    std::vector<Ref> pending;
+    long seq = 0;
+    int  ids = 0;
+
+    void submit(Hours h) {
+        const int id = ids++;
+        q.submit(Command{h, CommandType::Build, id});
+        pending.push_back({std::max(h, q.next_hour()), seq++, id});
+    }
+
+    // Runs a drain and returns the ids it applied; `react` may submit more.
+    template <class React>
+    std::vector<int> drain(Hours h, React&& react) {
+        std::vector<int> got;
+        q.drain_for_hour(h, [&](const Command& c) {
+            got.push_back(c.a);
+            react(c);
+        });
+        return got;
+    }
+
+    // What the model says a drain to `h` applies, given the same reactions.
+    std::vector<int> expect(Hours h) {
+        std::vector<int> want;
+        std::stable_sort(pending.begin(), pending.end(), [](const Ref& x, const Ref& y) {
+            return x.due != y.due ? x.due < y.due : x.seq < y.seq;
+        });
+        size_t k = 0;
+        while (k < pending.size() && pending[k].due <= h) want.push_back(pending[k++].id);
+        pending.erase(pending.begin(), pending.begin() + static_cast<long>(k));
+        return want;
+    }
+};
+
+static void matches_model(sim::Rng& rng) {
+    Model m;
+    Hours now = 0;
+    for (int step = 0; step < 8000; ++step) {
+        const uint32_t adds = rng.uniform_u32(4);
+        for (uint32_t i = 0; i < adds; ++i) {
+            Hours ahead;
+            switch (rng.uniform_u32(6)) {
+                case 0:  ahead = -static_cast<Hours>(rng.uniform_u32(5)); break;    // late
+                case 1:  ahead = rng.uniform_u32(4); break;                         // same hour
+                case 2:  ahead = rng.uniform_u32(300); break;                       // level 0/1
+                case 3:  ahead = rng.uniform_u32(20000); break;                     // level 1/2
+                case 4:  ahead = rng.uniform_u32(1u << 21); break;                  // level 3
+                default: ahead = static_cast<Hours>(rng.uniform_u32(1u << 28)); break; // overflow
+            }
+            m.submit(now + ahead);
+        }
+        // Mostly hour-by-hour, sometimes a long jump across block boundaries.
+        const uint32_t r = rng.uniform_u32(100);
+        const Hours to = now + (r < 90 ? 0 : r < 98 ? static_cast<Hours>(rng.uniform_u32(1000))
+                                                    : static_cast<Hours>(rng.uniform_u32(1u << 22)));
+        // No reactions here, so the model can be advanced independently.
+        const std::vector<int> got = m.drain(to, [](const Command&) {});
+        check(got == m.expect(to), "drain order");
+        check(m.q.size() == m.pending.size(), "size");
+        now = to + 1;
+        if (failures) return;
+    }
+    // Everything, including orders past the overflow horizon, comes out.
+    const Hours end = now + (Hours{1} << 29);
+    const std::vector<int> rest = m.drain(end, [](const Command&) {});
+    check(rest == m.expect(end) && m.q.empty(), "final drain");
+}
+
+static void submit_from_inside_drain() {
+    CommandQueue q;
+    q.submit(Command{5, CommandType::Build, 1});
+    q.submit(Command{5, CommandType::Build, 2});
+    q.submit(Command{6, CommandType::Build, 3});
+    std::vector<int> got;
+    q.drain_for_hour(5, [&](const Command& c) {
+        got.push_back(c.a);
+        if (c.a == 1) {
+            q.submit(Command{5, CommandType::Build, 10});    // same hour: runs now, after 2
+            q.submit(Command{3, CommandType::Build, 11});    // already past: runs now too
+            q.submit(Command{6, CommandType::Build, 12});    // next hour, after 3
+            q.submit(Command{5 + 300, CommandType::Build, 13});
+        }
+    });
+    check(got == std::vector<int>({1, 2, 10, 11}), "same-hour resubmits");
+    got.clear();
+    q.drain_for_hour(6, [&](const Command& c) { got.push_back(c.a); });
+    check(got == std::vector<int>({3, 12}), "next hour FIFO");
+    got.clear();
+    q.drain_for_hour(4000, [&](const Command& c) { got.push_back(c.a); });
+    check(got == std::vector<int>({13}) && q.empty(), "cascaded from level 1");
+
+    // Steady one-order-per-hour use.
+    for (Hours h = 4001; h < 6000; ++h) {
+        q.submit(Command{h, CommandType::Build, 0});
+        q.drain_for_hour(h, [](const Command&) {});
+    }
+    check(q.empty() && q.next_hour() == 6000, "steady state");
+}
+
+int main() {
+    sim::Rng rng(95);
+    matches_model(rng);
+    submit_from_inside_drain();
+    if (failures) return 1;
+    std::printf("command_queue: ok\n");
+    return 0;
+}
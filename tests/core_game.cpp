@@ -0,0 +1,285 @@
+#include "core/sim.hpp"
+#include "sim/Rng.h"
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// Game's running SPEC × instance totals against a from-scratch recompute,
+// the per-instance pools against a model, build costs, and the
+// command-driven step.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+static bool same(const BuildingTotals& a, const BuildingTotals& b) {
+    return a.gen_wq == b.gen_wq && a.load_w == b.load_w && a.upkeep_w == b.upkeep_w &&
+           a.ice_qq == b.ice_qq && a.metals_qq == b.metals_qq;
+}
+
+static void totals_track_counts(sim::Rng& rng) {
+    Game g;
+    g.s.credits = 1 << 30;
+    g.s.metals  = 1 << 30;
+    constexpr uint32_t kTypes = static_cast<uint32_t>(BuildingType::COUNT);
+    for (int i = 0; i < 200000; ++i) {
+        const auto t = static_cast<BuildingType>(rng.uniform_u32(kTypes));
+        const bool had = g.s.count[to_index(t)] > 0;
+        if (rng.uniform_u32(3)) check(g.tryBuild(t), "affordable build");
+        else check(g.destroy(t) == had, "destroy");
+    }
+    // A storm weights each extractor's loss by its own site.
+    g.depositDust(BuildingType::Extractor, BuildingPool::kFull / 8);
+    const BuildingTotals incremental = g.s.totals;
+    g.recomputeTotals();
+    check(same(incremental, g.s.totals), "incremental totals exact");
+
+    double gen = 0.0, demand = 0.0;
+    for (size_t i = 0; i < SPEC.size(); ++i) {
+        const double out = SPEC[i].power_out_kw * g.s.count[i];
+        if (out > 0.0) gen += out;
+        else demand -= out;
+        demand += SPEC[i].upkeep_kw * g.s.count[i];
+    }
+    g.step();
+    check(std::abs(g.s.power_kw - (gen - demand)) < 1e-6 * (gen + demand), "net power from SPEC");
+
+    // Tearing everything down returns to exactly zero.
+    for (size_t i = 0; i < SPEC.size(); ++i) {
+        while (g.destroy(static_cast<BuildingType>(i))) {}
+    }
+    check(same(g.s.totals, BuildingTotals{}), "empty colony totals");
+}
+
+// Mirrors each live instance so pool rows and handles can be checked.
+struct Model { BuildingId id; int32_t health, dust; };
+
+static void instances_track_model(sim::Rng& rng) {
+    Game g;
+    g.s.credits = 1 << 30;
+    g.s.metals  = 1 << 30;
+    constexpr int32_t kFull = BuildingPool::kFull;
+    constexpr uint32_t kTypes = static_cast<uint32_t>(BuildingType::COUNT);
+    std::vector<Model> live;
+    std::vector<BuildingId> dead;
+    for (int i = 0; i < 20000; ++i) {
+        const uint32_t op = rng.uniform_u32(10);
+        const size_t k = live.empty() ? 0 : rng.uniform_u32(static_cast<uint32_t>(live.size()));
+        if (op < 4 || live.empty()) {
+            BuildingId id;
+            check(g.tryBuild(static_cast<BuildingType>(rng.uniform_u32(kTypes)), &id), "build");
+            live.push_back({id, kFull, 0});
+        } else if (op == 4) {
+            check(g.destroy(live[k].id), "destroy by id");
+            dead.push_back(live[k].id);
+            live.erase(live.begin() + static_cast<long>(k));
+        } else if (op == 5) {
+            const int32_t amount = static_cast<int32_t>(rng.uniform_u32(kFull));
+            check(g.damage(live[k].id, amount), "damage");
+            if (live[k].health <= amount) {
+                dead.push_back(live[k].id);
+                live.erase(live.begin() + static_cast<long>(k));
+            } else {
+                live[k].health -= amount;
+            }
+        } else if (op == 6) {
+            check(g.repair(live[k].id), "repair");
+            live[k].health = kFull;
+        } else if (op == 7) {
+            check(g.clean(live[k].id), "clean");
+            live[k].dust = 0;
+        } else {
+            const auto t = static_cast<BuildingType>(rng.uniform_u32(kTypes));
+            const int32_t amount = static_cast<int32_t>(rng.uniform_u32(kFull / 8));
+            g.depositDust(t, amount);
+            for (auto& m : live) {
+                if (m.id.type == t) m.dust = std::min(kFull, m.dust + amount);
+            }
+        }
+    }
+    for (const auto& m : live) {
+        const BuildingPool& pool = g.s.buildings[to_index(m.id.type)];
+        if (!pool.valid(m.id.h)) { check(false, "live handle valid"); break; }
+        const size_t r = pool.row(m.id.h);
+        check(pool.health()[r] == m.health && pool.dust()[r] == m.dust, "instance state");
+        check(pool.eff()[r] == BuildingPool::efficiency(m.health, m.dust), "cached efficiency");
+        if (failures) break;
+    }
+    for (const auto& d : dead) {
+        if (g.destroy(d) || g.damage(d, 1) || g.repair(d) || g.clean(d)) { check(false, "stale handle"); break; }
+    }
+    const BuildingTotals incremental = g.s.totals;
+    const auto counts = g.s.count;
+    g.recomputeTotals();
+    check(same(incremental, g.s.totals) && counts == g.s.count, "delta totals exact");
+    size_t n = 0;
+    for (const auto& pool : g.s.buildings) n += pool.size();
+    check(n == live.size(), "instance count");
+}
+
+static void costs_and_commands() {
+    Game g;
+    g.s.credits = 1000;
+    g.s.metals  = 30;
+    check(!g.tryBuild(BuildingType::Reactor), "unaffordable reactor");
+    check(g.tryBuild(BuildingType::Solar), "solar");
+    check(g.s.credits == 500 && g.s.metals == 20 && g.s.count[to_index(BuildingType::Solar)] == 1,
+          "solar cost paid");
+    check(!g.tryBuild(BuildingType::Habitat) && g.s.credits == 500, "short on credits");
+
+    // A damaged, dusty panel generates in proportion; repair costs the
+    // missing share of its metals.
+    BuildingId panel;
+    Game d;
+    d.s.metals = 100;
+    check(d.tryBuild(BuildingType::Solar, &panel), "panel");
+    d.damage(panel, BuildingPool::kFull / 2);
+    d.depositDust(BuildingType::Solar, BuildingPool::kFull / 4);
+    d.forecastMode = true;
+    d.step();
+    check(d.s.power_kw == 2.0 * 0.5 * 0.75, "degraded output");
+    const int metals = d.s.metals;
+    check(d.repair(panel) && d.s.metals == metals - 5, "repair cost");
+    check(d.clean(panel), "clean");
+    d.step();
+    check(d.s.power_kw == 2.0, "restored output");
+
+    g.forecastMode = true; // no random events
+    g.submit(Command{1, CommandType::Build, static_cast<int>(BuildingType::Battery)});
+    g.step();
+    check(g.s.count[to_index(BuildingType::Battery)] == 0 && g.s.power_kw == 2.0, "hour 0: solar only");
+    g.step();
+    check(g.s.count[to_index(BuildingType::Battery)] == 1 && std::abs(g.s.power_kw - 1.98) < 1e-12,
+          "hour 1: battery built, upkeep drawn");
+    check(!g.s.brownout, "no brownout");
+    check(g.destroy(BuildingType::Solar), "destroy solar");
+    g.step();
+    check(g.s.brownout, "brownout without generation");
+}
+
+// Greenhouse plots follow their pool rows and feed the colony's stores.
+static void greenhouse_plots() {
+    Game g;
+    g.s.credits = 1 << 30;
+    g.s.metals  = 1 << 30;
+    g.forecastMode = true;
+    constexpr size_t kPer = GreenhousePlots::kPerGreenhouse;
+    BuildingId a, b, c;
+    check(g.tryBuild(BuildingType::Greenhouse, &a) && g.tryBuild(BuildingType::Greenhouse, &b) &&
+          g.tryBuild(BuildingType::Greenhouse, &c), "greenhouses");
+    check(g.s.plots.size() == 3 * kPer, "plots per greenhouse");
+    for (int i = 0; i < 3; ++i) g.tryBuild(BuildingType::Solar);
+
+    g.damage(c, BuildingPool::kFull / 2);
+    const BuildingPool& pool = g.s.buildings[to_index(BuildingType::Greenhouse)];
+    check(g.s.plots.light[pool.row(c.h) * kPer] == 0.5, "damaged greenhouse dims its plots");
+    check(g.destroy(a) && g.s.plots.size() == 2 * kPer, "plots removed with greenhouse");
+    check(g.s.plots.light[pool.row(c.h) * kPer] == 0.5 && g.s.plots.light[pool.row(b.h) * kPer] == 1.0,
+          "plots moved with their row");
+
+    const double o2 = g.s.oxygen, water = g.s.water;
+    g.step();
+    check(g.s.lastGrowth.o2Kg > 0.0 && g.s.oxygen == o2 + g.s.lastGrowth.o2Kg, "crops add oxygen");
+    check(g.s.water == water - g.s.lastGrowth.waterL, "irrigation drawn from water");
+    const double food = g.s.food;
+    g.s.water = 1e6;                              // no extractors here
+    for (int h = 0; h < 24 * 40; ++h) g.step();  // ~34 sols to harvest
+    check(g.s.food > food, "harvest feeds the colony");
+
+    // Irrigation never draws more than the colony holds.
+    const double full = g.s.lastGrowth.waterL;
+    g.s.water = 0.25 * full;
+    g.step();
+    check(g.s.water >= 0.0 && g.s.lastGrowth.waterL <= 0.25 * full + 1e-6, "irrigation limited by stores");
+    g.s.water = 0.0;
+    for (int h = 0; h < 24; ++h) {
+        g.step();
+        check(g.s.water == 0.0 && g.s.lastGrowth.waterL < 1e-6, "dry colony, no irrigation");
+    }
+}
+
+// Extractors stand on the richest metals site and mine by its richness.
+static void extractor_sites() {
+    Game g;
+    g.s.credits = 1 << 30;
+    g.s.metals  = 1 << 30;
+    g.forecastMode = true;
+    for (int i = 0; i < 3; ++i) g.tryBuild(BuildingType::Solar);
+    BuildingId a, b;
+    check(g.tryBuild(BuildingType::Extractor, &a), "extractor");
+    const mars::deposits::Site best = g.deposits().best_site(mars::deposits::Resource::Metals, -128, -128, 129, 129);
+    check(g.s.sites.x[0] == best.x && g.s.sites.y[0] == best.y && g.s.sites.metals[0] == best.richness,
+          "placed on the best site");
+    check(g.tryBuildAt(BuildingType::Extractor, 5, -9, &b), "extractor at");
+    check(g.s.sites.ice[1] == g.deposits().richness(mars::deposits::Resource::Ice, 5, -9), "site richness");
+    check(g.destroy(a) && g.s.sites.size() == 1 && g.s.sites.x[0] == 5, "site follows its row");
+    g.tryBuild(BuildingType::Extractor);
+
+    const int metals = g.s.metals;
+    const double water = g.s.water;
+    for (int h = 0; h < 100; ++h) g.step();
+    // Yield runs on Q16 richness: within a Q16 step per site of the floats.
+    const double sites = g.s.sites.metals[0] + g.s.sites.metals[1];
+    check(std::abs(g.s.totals.extracted_metals() - sites) <= 2.0 / BuildingPool::kFull, "Q16 site richness");
+    const double perHour = g.s.totals.extracted_metals() * g.metalsPerH;
+    const double mined = (g.s.metals - metals) + g.s.ore;
+    check(std::abs(mined - 100 * perHour) < 1e-9 * (1 + mined), "metals mined");
+    check(g.s.water > water || g.s.sites.ice[0] + g.s.sites.ice[1] == 0.0f, "ice mined");
+
+    Game h;
+    h.s.setSeed(g.s.rngSeed + 1);
+    check(h.deposits().params().seed == g.s.rngSeed + 1, "field follows the world seed");
+}
+
+// Reactor output follows its core: rated while settled, ramping through
+// transients, zero after a scram until repaired.
+static void reactor_cores() {
+    Game g;
+    g.s.credits = 1 << 30;
+    g.s.metals  = 1 << 30;
+    g.forecastMode = true;
+    BuildingId r;
+    check(g.tryBuild(BuildingType::Reactor, &r), "reactor");
+    const double upkeep = getSpec(BuildingType::Reactor).upkeep_kw;
+    g.step();
+    check(std::abs(g.s.power_kw - (6.0 - upkeep)) < 1e-9, "rated output");
+    g.step();
+    check(!g.s.reactorsDirty, "steady reactor needs no work");
+
+    check(g.setReactorRods(r, 0.5) && !g.setReactorRods(BuildingId{}, 0.5), "rods");
+    g.step();
+    const double ramping = g.s.power_kw;
+    for (int h = 0; h < 48; ++h) g.step();
+    check(ramping < 6.0 - upkeep && g.s.power_kw < ramping && !g.s.reactorsDirty, "settles lower");
+
+    check(g.setReactorRods(r, 0.0), "full power");
+    g.damage(r, BuildingPool::kFull / 2);  // half the cooling
+    for (int h = 0; h < 48; ++h) g.step();
+    check(g.s.reactors[0].scrammed && g.s.brownout, "overheats and scrams");
+    check(g.repair(r) && !g.s.reactors[0].scrammed, "repair resets the scram");
+    for (int h = 0; h < 48; ++h) g.step();
+    check(std::abs(g.s.power_kw - (6.0 - upkeep)) < 1e-9, "back at rated output");
+
+    g.depositDust(BuildingType::Reactor, BuildingPool::kFull / 4);
+    check(g.s.reactors[0].cooling == 0.75 && g.s.reactorsDirty, "dust cuts cooling");
+    check(g.clean(r) && g.s.reactors[0].cooling == 1.0, "cleaning restores it");
+    for (int h = 0; h < 48; ++h) g.step();
+    check(std::abs(g.s.power_kw - (6.0 - upkeep)) < 1e-9, "rated after cleaning");
+    check(g.destroy(r) && g.s.reactors.empty(), "core removed");
+    g.step();
+    check(g.s.power_kw == 0.0, "no reactor, no output");
+}
+
+int main() {
+    sim::Rng rng(96);
+    totals_track_counts(rng);
+    instances_track_model(rng);
+    costs_and_commands();
+    greenhouse_plots();
+    extractor_sites();
+    reactor_cores();
+    if (failures) return 1;
+    std::printf("core_game: ok\n");
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "systems/deposits.h"
+#include "sim/Rng.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Cached tiles and row evaluation against the scalar sample(), best_site()
+// against a brute-force scan, and the LRU's bookkeeping.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+namespace dp = mars::deposits;
+
+static bool bits_equal(float a, float b) { return std::memcmp(&a, &b, sizeof a) == 0; }
+
+static int32_t coord(sim::Rng& rng, uint32_t span) {
+    return static_cast<int32_t>(rng.uniform_u32(2 * span)) - static_cast<int32_t>(span);
+}
+
+static void cache_matches_sample(sim::Rng& rng) {
+    dp::Params p;
+    p.seed = 7;
+    dp::Field f(p, 32);
+    bool same = true;
+    // Mostly around the colony, where tiles stay cached; now and then far
+    // out, which generates (and evicts) one.
+    for (int i = 0; i < 100000 && same; ++i) {
+        const auto r = static_cast<dp::Resource>(rng.uniform_u32(2));
+        const uint32_t span = i % 500 == 0 ? 1000 : 96;
+        const int32_t x = coord(rng, span), y = coord(rng, span);
+        same = bits_equal(f.richness(r, x, y), dp::sample(p, r, x, y));
+    }
+    check(same, "tile cells equal sample()");
+
+    // Odd lengths exercise the scalar tail after the vector lanes.
+    std::vector<float> row(203);
+    same = true;
+    for (int i = 0; i < 200 && same; ++i) {
+        const int32_t x0 = coord(rng, 1 << 20), y = coord(rng, 1 << 20);
+        const size_t n = 1 + rng.uniform_u32(static_cast<uint32_t>(row.size()));
+        dp::sample_row(p, dp::Resource::Metals, x0, y, n, row.data());
+        for (size_t k = 0; k < n; ++k) {
+            same = same && bits_equal(row[k], dp::sample(p, dp::Resource::Metals, x0 + static_cast<int32_t>(k), y));
+        }
+    }
+    check(same, "sample_row equals sample()");
+
+    float lo = 1.0f, hi = 0.0f;
+    for (int32_t x = -500; x < 500; ++x) {
+        const float v = dp::sample(p, dp::Resource::Ice, x, 17);
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+    }
+    check(lo == 0.0f && hi > 0.0f && hi < 1.0f, "richness in [0, 1) with barren ground");
+}
+
+static void best_site_matches_scan(sim::Rng& rng) {
+    dp::Params p;
+    p.seed = 11;
+    dp::Field f(p, 16);
+    for (int i = 0; i < 100 && !failures; ++i) {
+        const auto r = static_cast<dp::Resource>(rng.uniform_u32(2));
+        const int32_t x0 = coord(rng, 300), y0 = coord(rng, 300);
+        const int32_t x1 = x0 + static_cast<int32_t>(rng.uniform_u32(150)), y1 = y0 + static_cast<int32_t>(rng.uniform_u32(150));
+        const dp::Site s = f.best_site(r, x0, y0, x1, y1);
+        if (x0 == x1 || y0 == y1) {
+            check(s.richness < 0.0f, "empty area");
+            continue;
+        }
+        float best = -1.0f;
+        for (int32_t y = y0; y < y1; ++y) {
+            for (int32_t x = x0; x < x1; ++x) {
+                const float v = dp::sample(p, r, x, y);
+                best = v > best ? v : best;
+            }
+        }
+        check(s.x >= x0 && s.x < x1 && s.y >= y0 && s.y < y1, "site inside area");
+        check(s.richness == best && dp::sample(p, r, s.x, s.y) == best, "richest site");
+    }
+}
+
+static void lru_and_seed() {
+    dp::Params p;
+    p.seed = 3;
+    dp::Field f(p, 4);
+    constexpr int32_t T = dp::Field::kTileSize;
+    for (int32_t t = 0; t < 4; ++t) f.richness(dp::Resource::Ice, t * T, 0);
+    check(f.stats().misses == 4 && f.stats().evictions == 0 && f.cachedTiles() == 4, "fill");
+    f.richness(dp::Resource::Ice, 0, 0);       // tile 0 most recent
+    f.richness(dp::Resource::Ice, 4 * T, 0);   // evicts tile 1
+    check(f.stats().hits == 1 && f.stats().evictions == 1 && f.cachedTiles() == 4, "evict");
+    f.richness(dp::Resource::Metals, 0, T - 1);
+    check(f.stats().hits == 2, "recent tile kept");
+    f.richness(dp::Resource::Ice, T, 0);
+    check(f.stats().misses == 6, "least recent tile evicted");
+
+    dp::Field g(p, 1);
+    const dp::Site a = f.best_site(dp::Resource::Metals, -200, -200, 200, 200);
+    const dp::Site b = g.best_site(dp::Resource::Metals, -200, -200, 200, 200);
+    check(a.x == b.x && a.y == b.y && a.richness == b.richness, "cache size doesn't change answers");
+    p.seed = 4;
+    g.reset(p);
+    check(g.cachedTiles() == 0, "reset drops tiles");
+    const dp::Site c = g.best_site(dp::Resource::Metals, -200, -200, 200, 200);
+    check(c.x != a.x || c.y != a.y, "another seed, another map");
+}
+
+int main() {
+    sim::Rng rng(99);
+    cache_matches_sample(rng);
+    best_site_matches_scan(rng);
+    lru_and_seed();
+    if (failures) return 1;
+    std::printf("deposits: ok\n");
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include "effects.hpp"
+#include "modifiers.hpp"
+#include "../engine/step.hpp"
+#include "../engine/events.hpp"
+#include "../engine/persist.hpp"
+#include "io/AsyncWriter.h"
+#include "sim/Rng.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// EffectStore ordering, cancellation and handle reuse against a brute-force
+// list, StatModifiers aggregates against a recomputed walk, then the engine's
+// dust storm driven by its absolute end hour.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+struct RefEffect { long long at; uint64_t seq; effects::EffectId id; int kind; };
+
+static void store_matches_reference(sim::Rng& rng) {
+    effects::EffectStore<16> store;
+    std::vector<RefEffect> ref;
+    uint64_t seq = 0;
+    for (long long now = 0; now < 5000; ++now) {
+        const uint32_t adds = rng.uniform_u32(3);
+        for (uint32_t a = 0; a < adds; ++a) {
+            const long long at = now + static_cast<long long>(rng.uniform_u32(40));
+            const int kind = static_cast<int>(rng.uniform_u32(1000));
+            const effects::EffectId id = store.add(effects::Effect{at, kind, "x"});
+            if (ref.size() == store.capacity() && id == effects::kNoEffect) continue;
+            check(id != effects::kNoEffect, "add below capacity");
+            ref.push_back({at, seq++, id, kind});
+        }
+        if (!ref.empty() && rng.uniform_u32(4) == 0) {
+            const size_t victim = rng.uniform_u32(static_cast<uint32_t>(ref.size()));
+            const effects::EffectId id = ref[victim].id;
+            check(store.cancel(id), "cancel live");
+            check(!store.cancel(id) && !store.contains(id), "cancel is one-shot");
+            ref.erase(ref.begin() + static_cast<long>(victim));
+        }
+
+        std::vector<RefEffect> due;
+        for (const auto& r : ref) if (r.at <= now) due.push_back(r);
+        std::sort(due.begin(), due.end(), [](const RefEffect& x, const RefEffect& y) {
+            return x.at != y.at ? x.at < y.at : x.seq < y.seq;
+        });
+        std::vector<int> got;
+        store.expire(now, [&](const effects::Effect& e) { got.push_back(e.kind); });
+        check(got.size() == due.size(), "expired count");
+        for (size_t i = 0; i < got.size() && i < due.size(); ++i) check(got[i] == due[i].kind, "expiry order");
+        for (const auto& d : due) check(!store.contains(d.id), "expired id is stale");
+        ref.erase(std::remove_if(ref.begin(), ref.end(), [now](const RefEffect& r) { return r.at <= now; }),
+                  ref.end());
+        check(store.size() == ref.size(), "live count");
+        for (const auto& r : ref) {
+            const effects::Effect* e = store.get(r.id);
+            check(e && e->kind == r.kind && e->expiresAt == r.at, "live lookup");
+        }
+        if (failures) return;
+    }
+}
+
+static void store_reentrant_expire() {
+    effects::EffectStore<4> store;
+    const effects::EffectId a = store.add({5, 1, "a"});
+    store.add({5, 2, "b"});
+    std::vector<int> seen;
+    // The first callback cancels nothing live (a is already gone) and
+    // schedules a follow-up that is itself due.
+    store.expire(5, [&](const effects::Effect& e) {
+        seen.push_back(e.kind);
+        if (e.kind == 1) {
+            check(!store.cancel(a), "cancel from inside expire");
+            store.add({4, 3, "c"});
+        }
+    });
+    check(seen == std::vector<int>({1, 3, 2}), "reentrant expire order");
+    check(store.empty() && store.nextExpiry(-1) == -1, "drained");
+
+    const effects::EffectId b = store.add({9, 0, "b"});
+    store.clear();
+    check(!store.contains(b) && store.add({9, 0, "c"}) != b, "clear keeps ids stale");
+}
+
+enum class TestStat : uint8_t { A, B, COUNT };
+
+static void modifiers_match_walk(sim::Rng& rng) {
+    using effects::ModOp;
+    effects::StatModifiers<TestStat, 12> mods;
+    struct Live { effects::ModifierId id; TestStat stat; ModOp op; double value; };
+    std::vector<Live> live;
+    for (int t = 0; t < 20000; ++t) {
+        if (live.size() < 12 && (live.empty() || rng.uniform_u32(2))) {
+            const TestStat stat = rng.uniform_u32(2) ? TestStat::A : TestStat::B;
+            const ModOp op = rng.uniform_u32(2) ? ModOp::Add : ModOp::Mul;
+            // Factors in (0.5, 1.5], with the odd exact zero (a tripped breaker).
+            double v = op == ModOp::Add ? rng.uniform01() * 4.0 - 2.0 : 0.5 + rng.uniform01();
+            if (op == ModOp::Mul && rng.uniform_u32(16) == 0) v = 0.0;
+            live.push_back({mods.add(stat, op, v), stat, op, v});
+        } else {
+            const size_t victim = rng.uniform_u32(static_cast<uint32_t>(live.size()));
+            check(mods.remove(live[victim].id), "remove live");
+            check(!mods.remove(live[victim].id), "remove is one-shot");
+            live.erase(live.begin() + static_cast<long>(victim));
+        }
+        for (TestStat stat : {TestStat::A, TestStat::B}) {
+            double off = 0.0, fac = 1.0;
+            for (const auto& l : live) {
+                if (l.stat != stat) continue;
+                if (l.op == ModOp::Add) off += l.value;
+                else fac *= l.value;
+            }
+            check(std::fabs(mods.offset(stat) - off) < 1e-9, "offset aggregate");
+            check(std::fabs(mods.factor(stat) - fac) < 1e-9 * (1.0 + fac), "factor aggregate");
+        }
+        check(mods.size() == live.size(), "modifier count");
+        if (failures) return;
+    }
+    for (const auto& l : live) mods.remove(l.id);
+    // Emptied stats are exact identities again, whatever the history.
+    check(mods.offset(TestStat::A) == 0.0 && mods.factor(TestStat::A) == 1.0 &&
+          mods.apply(TestStat::B, 3.25) == 3.25, "identity after drain");
+    check(mods.add(TestStat::A, ModOp::Mul, 1.0) != effects::kNoModifier, "add after drain");
+}
+
+static void dust_storm_clears_on_end_hour() {
+    mars::GameState s;
+    mars::initDefaultGame(s, 7u);
+    std::vector<std::string> log;
+    mars::StepOpts opt;
+    opt.spawn_random_events = false;
+    opt.sink = [&](const mars::LogMsg& m) { log.emplace_back(m.text); };
+
+    mars::startDustStorm(s, 5, opt);
+    check(s.modifiers.factor(mars::Stat::SolarOutput) == 0.25, "storm scales solar output");
+    check(s.weather.dustStormEndHour == 5 && s.weather.dustStormHoursLeft(s.hour) == 5, "end hour");
+    for (int i = 0; i < 4; ++i) {
+        mars::simulateHour(s, opt);
+        mars::tickEffects(s, opt);
+    }
+    check(s.weather.dustStorm && s.weather.dustStormHoursLeft(s.hour) == 1, "still storming");
+
+    // Round trip through a background save, and through the pre-end-hour format.
+    const std::string path = "effects_test.sav";
+    {
+        mars::io::AsyncWriter checkpoints;
+        check(mars::saveGame(s, checkpoints, path), "save");
+        check(checkpoints.drain(), "save written");
+    }
+    mars::GameState loaded;
+    mars::initDefaultGame(loaded, 1u);
+    check(mars::loadGame(loaded, path) && loaded.weather.dustStormEndHour == 5 &&
+          loaded.effects.size() == 1 && loaded.modifiers.factor(mars::Stat::SolarOutput) == 0.25, "load");
+    {
+        std::ofstream f(path);
+        f << "hour=4\nweather_dustStorm=1\nweather_dustStormHours=1\nweather_solarMultiplier=0.25\n";
+    }
+    mars::GameState legacy;
+    mars::initDefaultGame(legacy, 1u);
+    check(mars::loadGame(legacy, path) && legacy.weather.dustStormEndHour == 5, "legacy load");
+    std::remove(path.c_str());
+
+    log.clear();
+    mars::simulateHour(s, opt);
+    mars::tickEffects(s, opt);
+    check(!s.weather.dustStorm && s.effects.empty(), "cleared at end hour");
+    check(s.modifiers.size() == 0 && s.modifiers.factor(mars::Stat::SolarOutput) == 1.0, "storm modifier removed");
+    check(log.size() == 1 && log[0] == "[Weather] The dust storm has cleared.", "clear goes to the sink");
+
+    // An early clear (scripts do this) drops the pending expiry.
+    mars::startDustStorm(s, 10, opt);
+    mars::clearDustStorm(s, opt);
+    check(s.effects.empty(), "manual clear cancels the effect");
+}
+
+// With both fixed-capacity stores full, a storm still cuts solar output and
+// still ends on its end hour.
+static void dust_storm_with_full_stores() {
+    mars::GameState s;
+    mars::initDefaultGame(s, 7u);
+    mars::StepOpts opt;
+    opt.spawn_random_events = false;
+    opt.sink = mars::null_sink;
+    while (s.effects.add(effects::Effect{1'000'000, -1, "filler"}) != effects::kNoEffect) {}
+    while (s.modifiers.add(mars::Stat::CriticalLoad, effects::ModOp::Add, 0.0) != effects::kNoModifier) {}
+    s.hour = 12;   // midday, so the panels produce
+
+    mars::GameState clear = s;
+    mars::simulateHour(clear, opt);
+    mars::startDustStorm(s, 3, opt);
+    check(s.weather.dustStorm && s.weather.dustStormEffect == effects::kNoEffect &&
+              s.weather.dustStormModifier == effects::kNoModifier, "stores full: storm untracked");
+    mars::simulateHour(s, opt);
+    mars::tickEffects(s, opt);
+    check(std::abs(s.lastPower.producers - 0.25 * clear.lastPower.producers) < 1e-9, "untracked storm cuts solar");
+    mars::simulateHour(s, opt);
+    mars::tickEffects(s, opt);
+    check(s.weather.dustStorm, "still storming");
+    mars::simulateHour(s, opt);
+    mars::tickEffects(s, opt);
+    check(!s.weather.dustStorm && s.hour == 15, "untracked storm ends on its hour");
+    check(s.effects.size() == s.effects.capacity(), "fillers untouched");
+}
+
+int main() {
+    sim::Rng rng(93);
+    store_matches_reference(rng);
+    store_reentrant_expire();
+    modifiers_match_walk(rng);
+    dust_storm_clears_on_end_hour();
+    dust_storm_with_full_stores();
+    if (failures) return 1;
+    std::printf("effects: ok\n");
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "sim/EventLog.h"
+#include "sim/Rng.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// One tick's lines emitted through 1, 2 and 8 shards, each worker taking
+// its (system, entity) groups in shuffled order, must flush to the same
+// bytes as a single worker emitting in canonical order, with `seq`
+// counting each entity's lines.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+// Lines one entity emits for one system, in order.
+struct Group {
+    uint16_t system;
+    uint32_t entity;
+    std::vector<std::string> lines;
+};
+
+static std::vector<Group> make_tick(sim::Rng& rng, uint64_t tick) {
+    std::vector<Group> groups;
+    for (uint16_t sys = 0; sys < 4; ++sys) {
+        for (uint32_t ent = 0; ent < 200; ++ent) {
+            const uint32_t n = rng.uniform_u32(4);  // most entities emit 0..3 lines
+            if (n == 0) continue;
+            Group g{sys, ent, {}};
+            for (uint32_t k = 0; k < n; ++k) {
+                g.lines.push_back("t" + std::to_string(tick) + " s" + std::to_string(sys) + " e" +
+                                  std::to_string(ent) + " #" + std::to_string(k));
+            }
+            groups.push_back(std::move(g));
+        }
+    }
+    return groups;
+}
+
+static std::string flush_to_bytes(sim::OrderedLog& log, uint32_t* maxSeq, bool* seqOk) {
+    std::string out;
+    sim::LogKey last;
+    bool first = true;
+    log.flush([&](const sim::LogKey& k, std::string_view text) {
+        // seq is 0 for an entity's first line and counts up from there.
+        const bool sameEntity = !first && k.tick == last.tick && k.system == last.system && k.entity == last.entity;
+        *seqOk = *seqOk && k.seq == (sameEntity ? last.seq + 1 : 0);
+        *maxSeq = k.seq > *maxSeq ? k.seq : *maxSeq;
+        out += sim::OrderedLog::format(k, text);
+        out += '\n';
+        last = k;
+        first = false;
+    });
+    return out;
+}
+
+static void shards_match_single_worker(sim::Rng& rng) {
+    for (uint64_t tick = 1; tick <= 20; ++tick) {
+        const std::vector<Group> groups = make_tick(rng, tick);
+
+        sim::OrderedLog canonical(1);
+        for (const Group& g : groups) {
+            for (const std::string& l : g.lines) canonical.shard(0).emit(tick, g.system, g.entity, l);
+        }
+        uint32_t maxSeq = 0;
+        bool seqOk = true;
+        const std::string expect = flush_to_bytes(canonical, &maxSeq, &seqOk);
+        check(seqOk && maxSeq == 2, "seq counts each entity's lines");
+
+        for (unsigned workers : {1u, 2u, 8u}) {
+            // Each group goes to one worker; each worker emits its groups in
+            // a shuffled order, keeping a group's lines together.
+            std::vector<std::vector<const Group*>> owned(workers);
+            for (const Group& g : groups) owned[rng.uniform_u32(workers)].push_back(&g);
+            sim::OrderedLog log(workers);
+            for (unsigned w = 0; w < workers; ++w) {
+                auto& mine = owned[w];
+                for (size_t i = mine.size(); i > 1; --i) {
+                    std::swap(mine[i - 1], mine[rng.uniform_u32(static_cast<uint32_t>(i))]);
+                }
+                for (const Group* g : mine) {
+                    for (const std::string& l : g->lines) log.shard(w).emit(tick, g->system, g->entity, l);
+                }
+            }
+            uint32_t shardedMax = 0;
+            bool shardedSeq = true;
+            check(flush_to_bytes(log, &shardedMax, &shardedSeq) == expect, "sharded flush bytes");
+            check(shardedSeq && shardedMax == maxSeq, "sharded seq");
+            check(flush_to_bytes(log, &shardedMax, &shardedSeq).empty(), "flush clears the shards");
+        }
+    }
+}
+
+int main() {
+    sim::Rng rng(80);
+    shards_match_single_worker(rng);
+    if (failures) return 1;
+    std::printf("event_log: ok\n");
+    return 0;
+}
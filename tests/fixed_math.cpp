@@ -0,0 +1,97 @@
+#include "fixed_math.h"
+#include "sim/Rng.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// fixed_math against long-double libm, within the documented bounds.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+using Q32 = FixedPoint<int64_t, 32>;   // fine enough to see the internal error
+
+static_assert(fixed_cos(FP{0}) == FP::fromInt(1), "cos 0");
+static_assert(fixed_exp(FP{0}) == FP::fromInt(1), "exp 0");
+
+template <class Fx>
+static double ulp() { return 1.0 / static_cast<double>(Fx::SCALE); }
+
+static double err_of(FP got, long double want) { return std::fabs(static_cast<double>(got.toDouble() - want)); }
+static double err_of(Q32 got, long double want) { return std::fabs(static_cast<double>(got.toDouble() - want)); }
+
+template <class Fx>
+static void within_bounds(sim::Rng& rng) {
+    const double half = 0.5 * ulp<Fx>();
+    double worst_sin = 0, worst_cos = 0, worst_exp = 0, worst_atan = 0;
+    for (int t = 0; t < 200000; ++t) {
+        const double xd = (rng.uniform01() - 0.5) * (rng.uniform_u32(4) == 0 ? 2e4 : 20.0);
+        const Fx x = Fx::fromDouble(xd);
+        const long double xl = static_cast<long double>(x.toDouble());   // the value actually passed
+        worst_sin = std::fmax(worst_sin, err_of(fixed_sin(x), std::sin(xl)));
+        worst_cos = std::fmax(worst_cos, err_of(fixed_cos(x), std::cos(xl)));
+
+        const Fx e = Fx::fromDouble((rng.uniform01() - 0.5) * 40.0);
+        const long double ev = std::exp(static_cast<long double>(e.toDouble()));
+        worst_exp = std::fmax(worst_exp, (err_of(fixed_exp(e), ev) - half) / static_cast<double>(ev));
+
+        const Fx y = Fx::fromDouble((rng.uniform01() - 0.5) * 1e3), z = Fx::fromDouble((rng.uniform01() - 0.5) * 1e3);
+        worst_atan = std::fmax(worst_atan, err_of(fixed_atan2(y, z),
+                                                  std::atan2(static_cast<long double>(y.toDouble()),
+                                                             static_cast<long double>(z.toDouble()))));
+
+        const Fx s = Fx::fromDouble(rng.uniform01() * 1e6);
+        const long double sv = std::sqrt(static_cast<long double>(s.toDouble()));
+        check(err_of(fixed_sqrt(s), sv) <= half, "sqrt not correctly rounded");
+        if (failures) return;
+    }
+    check(worst_sin  <= 5e-9 + half, "sin error bound");
+    check(worst_cos  <= 5e-9 + half, "cos error bound");
+    check(worst_exp  <= 6e-9,        "exp relative error bound");
+    check(worst_atan <= 2e-8 + half, "atan2 error bound");
+}
+
+static void edges() {
+    check(fixed_exp(FP::fromInt(100)) == FP::max(), "exp saturates");
+    check(fixed_exp(FP::fromInt(-100)) == FP{0}, "exp underflows to 0");
+    check(fixed_sqrt(FP::fromInt(-4)) == FP{0}, "sqrt of negative");
+    check(fixed_sqrt(FP::fromInt(9)) == FP::fromInt(3), "sqrt 9");
+    check(fixed_sqrt(FP::max()) == FP{static_cast<int64_t>(std::sqrt(std::ldexp(9223372036854775807.0, 16)) + 0.5)},
+          "sqrt of max");
+    check(fixed_atan2(FP{0}, FP{0}) == FP{0}, "atan2(0, 0)");
+    check(fixed_atan2(FP{0}, FP::fromInt(-1)) == fixed_pi<FP>(), "atan2(0, -1) is pi");
+    check(fixed_atan2(FP::fromInt(1), FP{0}) == FP::fromDouble(1.5707963267948966), "atan2(1, 0)");
+    check(fixed_atan2(FP::lowest(), FP::max()) == FP::fromDouble(-0.7853981633974483), "atan2 at the range ends");
+    check(fixed_sin(FP::fromInt(1'000'000)) == FP::fromDouble(std::sin(1'000'000.0)), "sin far out");
+}
+
+static void batch_matches_scalar(sim::Rng& rng) {
+    const size_t n = 1001;
+    std::vector<FP> x(n), y(n), out(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = FP::fromDouble((rng.uniform01() - 0.5) * 30.0);
+        y[i] = FP::fromDouble((rng.uniform01() - 0.5) * 30.0);
+    }
+    fixed_sin(n, x.data(), out.data());
+    for (size_t i = 0; i < n; ++i) check(out[i] == fixed_sin(x[i]), "batch sin");
+    fixed_cos(n, x.data(), out.data());
+    for (size_t i = 0; i < n; ++i) check(out[i] == fixed_cos(x[i]), "batch cos");
+    fixed_exp(n, x.data(), out.data());
+    for (size_t i = 0; i < n; ++i) check(out[i] == fixed_exp(x[i]), "batch exp");
+    fixed_sqrt(n, x.data(), out.data());
+    for (size_t i = 0; i < n; ++i) check(out[i] == fixed_sqrt(x[i]), "batch sqrt");
+    fixed_atan2(n, y.data(), x.data(), out.data());
+    for (size_t i = 0; i < n; ++i) check(out[i] == fixed_atan2(y[i], x[i]), "batch atan2");
+}
+
+int main() {
+    sim::Rng rng(92);
+    within_bounds<FP>(rng);
+    within_bounds<Q32>(rng);
+    edges();
+    batch_matches_scalar(rng);
+    if (failures) return 1;
+    std::printf("fixed_math: ok\n");
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include "fixed_point.h"
+#include "sim/Rng.h"
+#include <cstdio>
+#include <vector>
+
+// FixedPoint rounding against an exact reference, the saturating and checked
+// variants, the 128-bit fallback and the array kernels.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+// Rounding modes on halves and quarters, at compile time (raw 1 == 0.5).
+using Q1 = FixedPoint<int32_t, 1>;
+static_assert(Q1::mul<Round::Floor>      (Q1{3},  Q1{1}).raw ==  1, "floor  0.75");
+static_assert(Q1::mul<Round::TowardZero> (Q1{3},  Q1{1}).raw ==  1, "trunc  0.75");
+static_assert(Q1::mul<Round::NearestEven>(Q1{3},  Q1{1}).raw ==  2, "even   0.75");
+static_assert(Q1::mul<Round::Floor>      (Q1{-3}, Q1{1}).raw == -2, "floor -0.75");
+static_assert(Q1::mul<Round::TowardZero> (Q1{-3}, Q1{1}).raw == -1, "trunc -0.75");
+static_assert(Q1::mul<Round::NearestEven>(Q1{-3}, Q1{1}).raw == -2, "even  -0.75");
+static_assert(Q1::mul<Round::NearestEven>(Q1{1},  Q1{1}).raw ==  0, "even   0.25");
+static_assert(Q1::mul<Round::Floor>      (Q1{-1}, Q1{1}).raw == -1, "floor -0.25");
+static_assert(FP::fromInt(3) * FP::fromInt(-2) == FP::fromInt(-6), "FP mul");
+static_assert(FP::fromInt(7) / FP::fromInt(2) == FP{7 * FP::SCALE / 2}, "FP div");
+
+// Exact n/d in the given mode, through the built-in 128-bit type.
+#if defined(__SIZEOF_INT128__)
+using Ref = fixed_detail::int128;
+
+static Ref ref_round(Ref n, Ref d, Round mode) {
+    Ref q = n / d;
+    const Ref r = n - q * d;
+    if (r == 0) return q;
+    const bool negative = (n < 0) != (d < 0);
+    switch (mode) {
+        case Round::Floor:      return negative ? q - 1 : q;
+        case Round::TowardZero: return q;
+        case Round::NearestEven: {
+            const Ref r2 = 2 * (r < 0 ? -r : r), ad = d < 0 ? -d : d;
+            if (r2 > ad || (r2 == ad && (q & 1) != 0)) q += negative ? -1 : 1;
+            return q;
+        }
+    }
+    return q;
+}
+
+template <class Fx>
+static void rounding_matches_reference(sim::Rng& rng) {
+    using Rep = typename Fx::rep;
+    constexpr int bits = 8 * sizeof(Rep);
+    const auto draw = [&rng] {
+        const uint64_t mag = rng.next_u64() >> (64 - bits + 1 + rng.uniform_u32(bits - 1));
+        return static_cast<Rep>(rng.uniform_u32(2) ? -static_cast<int64_t>(mag) : static_cast<int64_t>(mag));
+    };
+    for (int t = 0; t < 20000; ++t) {
+        const Fx a{draw()}, b{draw()};
+        const Ref p = Ref(a.raw) * Ref(b.raw);
+        const Ref lo = Fx::kMin, hi = Fx::kMax;
+        for (Round m : {Round::Floor, Round::TowardZero, Round::NearestEven}) {
+            const Ref want = ref_round(p, Fx::SCALE, m);
+            Fx got{}, sat{};
+            bool ok = false;
+            switch (m) {
+                case Round::Floor:       ok = Fx::template mul_checked<Round::Floor>(a, b, got);
+                                         sat = Fx::template mul_sat<Round::Floor>(a, b); break;
+                case Round::TowardZero:  ok = Fx::template mul_checked<Round::TowardZero>(a, b, got);
+                                         sat = Fx::template mul_sat<Round::TowardZero>(a, b); break;
+                case Round::NearestEven: ok = Fx::template mul_checked<Round::NearestEven>(a, b, got);
+                                         sat = Fx::template mul_sat<Round::NearestEven>(a, b); break;
+            }
+            const bool fits = want >= lo && want <= hi;
+            check(ok == fits, "mul_checked range");
+            if (fits) check(Ref(got.raw) == want, "mul rounding");
+            check(Ref(sat.raw) == (want < lo ? lo : want > hi ? hi : want), "mul_sat");
+        }
+        if (b.raw == 0) continue;
+        const Ref n = Ref(a.raw) * Fx::SCALE;
+        for (Round m : {Round::Floor, Round::TowardZero, Round::NearestEven}) {
+            const Ref want = ref_round(n, b.raw, m);
+            Fx got{};
+            bool ok = false;
+            switch (m) {
+                case Round::Floor:       ok = Fx::template div_checked<Round::Floor>(a, b, got); break;
+                case Round::TowardZero:  ok = Fx::template div_checked<Round::TowardZero>(a, b, got); break;
+                case Round::NearestEven: ok = Fx::template div_checked<Round::NearestEven>(a, b, got); break;
+            }
+            const bool fits = want >= lo && want <= hi;
+            check(ok == fits, "div_checked range");
+            if (fits) check(Ref(got.raw) == want, "div rounding");
+        }
+        if (failures) return;
+    }
+}
+
+// The portable I128 must agree with __int128 wherever FixedPoint uses it.
+static void i128_matches_builtin(sim::Rng& rng) {
+    using fixed_detail::I128;
+    const auto same = [](I128 x, Ref y) {
+        return x.lo == static_cast<uint64_t>(y) && x.hi == static_cast<uint64_t>(y >> 64);
+    };
+    for (int t = 0; t < 20000; ++t) {
+        const int64_t a = static_cast<int64_t>(rng.next_u64() >> rng.uniform_u32(64)) * (rng.uniform_u32(2) ? -1 : 1);
+        int64_t b = static_cast<int64_t>(rng.next_u64() >> rng.uniform_u32(64)) * (rng.uniform_u32(2) ? -1 : 1);
+        const int64_t c = static_cast<int64_t>(rng.next_u64());
+        if (b == 0) b = 1;
+        const I128 p = I128(a) * I128(c);
+        const Ref rp = Ref(a) * Ref(c);
+        check(same(p, rp), "I128 mul");
+        const int s = static_cast<int>(rng.uniform_u32(128));
+        check(same(p >> s, rp >> s), "I128 shift");
+        check(same(p / I128(b), rp / b), "I128 div");
+        check(same(p % I128(b), rp % b), "I128 rem");
+        check(same(p + I128(b), rp + b) && same(p - I128(b), rp - b), "I128 add/sub");
+        check((p < I128(b)) == (rp < b) && (p == p) && !(p != p), "I128 compare");
+        if (failures) return;
+    }
+}
+#endif
+
+static void saturating_and_checked() {
+    const FP big = FP::max(), small = FP::lowest(), two = FP::fromInt(2);
+    check(FP::add_sat(big, two) == big, "add_sat high");
+    check(FP::sub_sat(small, two) == small, "sub_sat low");
+    check(FP::mul_sat(big, two) == big && FP::mul_sat(big, -two) == small, "mul_sat");
+    check(FP::div_sat(two, FP{0}) == big && FP::div_sat(-two, FP{0}) == small, "div_sat by zero");
+    check(FP::div_sat(FP{0}, FP{0}) == FP{0}, "div_sat 0/0");
+
+    FP out = FP::fromInt(5);
+    check(!FP::add_checked(big, two, out) && out == FP::fromInt(5), "add_checked overflow");
+    check(!FP::mul_checked(big, two, out) && out == FP::fromInt(5), "mul_checked overflow");
+    check(!FP::div_checked(two, FP{0}, out) && out == FP::fromInt(5), "div_checked by zero");
+    check(FP::mul_checked(two, two, out) && out == FP::fromInt(4), "mul_checked ok");
+
+    // The old decimal FP overflowed raw * raw past ~3e6 * 3e6 Wh; the wide
+    // intermediate doesn't.
+    const FP e = FP::fromDouble(3.0e6);
+    check(FP::mul(e, FP::fromDouble(0.5)) == FP::fromDouble(1.5e6), "large mul");
+    check(FP::div(e, FP::fromDouble(0.25)) == FP::fromDouble(1.2e7), "large div");
+}
+
+template <class Fx>
+static void kernels_match_scalar(sim::Rng& rng) {
+    for (size_t n : {0u, 1u, 7u, 1000u}) {
+        std::vector<Fx> a(n), b(n), sum(n), prod(n), clamped(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = Fx{static_cast<typename Fx::rep>(rng.next_u64() >> 40) - (typename Fx::rep{1} << 22)};
+            b[i] = Fx{static_cast<typename Fx::rep>(rng.next_u64() >> 44) - (typename Fx::rep{1} << 18)};
+        }
+        const Fx lo = Fx::fromInt(-20), hi = Fx::fromInt(30);
+        fixed_add(n, a.data(), b.data(), sum.data());
+        fixed_mul<Round::NearestEven>(n, a.data(), b.data(), prod.data());
+        fixed_clamp(n, a.data(), lo, hi, clamped.data());
+        for (size_t i = 0; i < n; ++i) {
+            check(sum[i] == a[i] + b[i], "fixed_add");
+            check(prod[i] == Fx::template mul<Round::NearestEven>(a[i], b[i]), "fixed_mul");
+            check(clamped[i] == (a[i] < lo ? lo : a[i] > hi ? hi : a[i]), "fixed_clamp");
+        }
+        // In place.
+        const std::vector<Fx> a0 = a;
+        fixed_mul(n, a.data(), b.data(), a.data());
+        for (size_t i = 0; i < n; ++i) check(a[i] == a0[i] * b[i], "fixed_mul in place");
+    }
+}
+
+int main() {
+    sim::Rng rng(91);
+#if defined(__SIZEOF_INT128__)
+    rounding_matches_reference<FixedPoint<int32_t, 16>>(rng);
+    rounding_matches_reference<FixedPoint<int64_t, 16>>(rng);
+    rounding_matches_reference<FixedPoint<int64_t, 32>>(rng);
+    i128_matches_builtin(rng);
+#endif
+    saturating_and_checked();
+    kernels_match_scalar<FixedPoint<int32_t, 16>>(rng);
+    kernels_match_scalar<FP>(rng);
+    if (failures) return 1;
+    std::printf("fixed_point: ok\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "../include/mars/frame_arena.hpp"
+#include "../engine/step.hpp"
+#include "sim/Simulation.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Counts every global operator new so we can assert the steady-state tick
+// and hourly step never touch the global heap.
+static std::atomic<long> g_news{0};
+
+void* operator new(std::size_t n) {
+    ++g_news;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+int main() {
+    // Arena basics: growth folds into a single block at reset().
+    mars::FrameArena arena(1024);
+    for (int frame = 0; frame < 3; ++frame) {
+        {
+            std::pmr::vector<double> v(&arena);
+            for (int i = 0; i < 5000; ++i) v.push_back(i);
+        }
+        arena.reset();
+    }
+    const size_t warm = arena.upstreamAllocs();
+    for (int frame = 0; frame < 10; ++frame) {
+        {
+            std::pmr::vector<double> v(&arena);
+            for (int i = 0; i < 5000; ++i) v.push_back(i);
+        }
+        arena.reset();
+    }
+    check(arena.upstreamAllocs() == warm, "arena kept allocating upstream at steady state");
+
+    // Hourly engine step + forecast into the arena.
+    mars::GameState s;
+    mars::initDefaultGame(s, 42u);
+    mars::StepOpts opt;
+    opt.sink = mars::null_sink;
+    mars::FrameArena forecastArena;
+    for (int i = 0; i < 48; ++i) {
+        mars::simulateHour(s, opt);
+        mars::tickEffects(s, opt);
+        { auto f = mars::runForecast(s, 24, &forecastArena); }
+        forecastArena.reset();
+    }
+    long before = g_news.load();
+    for (int i = 0; i < 24 * 30; ++i) {
+        mars::simulateHour(s, opt);
+        mars::tickEffects(s, opt);
+        { auto f = mars::runForecast(s, 24, &forecastArena); }
+        forecastArena.reset();
+    }
+    check(g_news.load() == before, "simulateHour/runForecast allocated from the global heap");
+
+    // Fixed-step simulation tick.
+    sim::Simulation sim(12345);
+    sim.world().colonists.push_back({1, 20000, 0, 0, 293'000});
+    sim.world().habitats.push_back({1, 50000, 101'325'000, 15'000});
+    sim::Input in{};
+    for (int i = 0; i < 100; ++i) sim.tick(in);
+    before = g_news.load();
+    for (int i = 0; i < 10'000; ++i) sim.tick(in);
+    check(g_news.load() == before, "Simulation::tick allocated from the global heap");
+
+    if (failures) return 1;
+    std::printf("frame_arena: ok\n");
+    return 0;
+}
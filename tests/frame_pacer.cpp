@@ -0,0 +1,105 @@
+#include "sim/FramePacer.h"
+#include <cstdio>
+#include <thread>
+
+// Lateness quantiles from a hand-filled histogram, then real waits: the
+// histogram accounts for every wait, a spin window wider than the wait
+// never sleeps, and wait_next() keeps its deadlines on a fixed grid.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+using Clock = sim::FramePacer::Clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+static void quantiles() {
+    sim::PacerStats st;
+    check(st.late_quantile_us(0.5) == 0, "no waits");
+    st.waits = 100;
+    st.late_bucket[0] = 50;                          // < 10 us
+    st.late_bucket[2] = 49;                          // 20..30 us
+    st.late_bucket[sim::PacerStats::kBuckets] = 1;   // overflow
+    st.late_max_ns = 5'000'000;
+    check(st.late_quantile_us(0.0) == 10, "p0");
+    check(st.late_quantile_us(0.5) == 10, "p50 in the first bucket");
+    check(st.late_quantile_us(0.51) == 30, "p51 in the third bucket");
+    check(st.late_quantile_us(0.99) == 30, "p99");
+    check(st.late_quantile_us(1.0) == 5000, "overflow reports the max");
+}
+
+static uint64_t bucket_total(const sim::PacerStats& st) {
+    uint64_t n = 0;
+    for (uint64_t b : st.late_bucket) n += b;
+    return n;
+}
+
+static void waits_and_histogram() {
+    sim::FramePacer pacer(200);
+    bool onTime = true;
+    for (int i = 0; i < 10; ++i) {
+        const auto deadline = Clock::now() + milliseconds(2);
+        pacer.wait_until(deadline);
+        onTime = onTime && Clock::now() >= deadline;
+    }
+    const sim::PacerStats& st = pacer.stats();
+    check(onTime, "never returns early");
+    check(st.waits == 10 && bucket_total(st) == 10, "every wait in the histogram");
+    check(st.slept_ns > 10 * 1'000'000ull, "bulk of the wait slept");
+    check(st.late_max_ns * 10 >= st.late_sum_ns, "max bounds the mean");
+
+    pacer.wait_until(Clock::now() - milliseconds(1));
+    check(pacer.stats().waits == 10, "a passed deadline isn't a wait");
+}
+
+static void spin_only() {
+    // Spin window wider than the wait: no sleep at all.
+    sim::FramePacer pacer(5'000);
+    pacer.wait_until(Clock::now() + milliseconds(1));
+    const sim::PacerStats& st = pacer.stats();
+    check(st.waits == 1, "spin wait counted");
+    check(st.slept_ns < 100'000, "spin-only wait doesn't sleep");
+    check(st.spun_ns >= 900'000, "spun through the wait");
+}
+
+static void fixed_grid() {
+    // The schedule on made-up times, so scheduler noise can't move it.
+    sim::FramePacer pacer;
+    const auto period = milliseconds(20);
+    const Clock::time_point t0 = Clock::now();
+    check(pacer.advance(t0, period) == t0 + period, "first deadline one period out");
+    for (int i = 2; i <= 10; ++i) {
+        // Woken anywhere up to a period late: the grid holds.
+        const auto now = t0 + (i - 1) * period + microseconds(i * 1'999);
+        check(pacer.advance(now, period) == t0 + i * period, "deadlines stay on the grid");
+    }
+    check(pacer.stats().restarts == 0, "no restart within a period");
+
+    // More than a period behind: restart from now, don't burst.
+    const auto late = pacer.next_deadline() + period + microseconds(1);
+    check(pacer.advance(late, period) == late + period && pacer.stats().restarts == 1,
+          "re-anchored after falling behind");
+    check(pacer.advance(late + period, period) == late + 2 * period, "new grid from the restart");
+
+    // Real waits land on the same schedule.
+    sim::FramePacer real(200);
+    real.wait_next(period);
+    const auto first = real.next_deadline();
+    for (int i = 1; i <= 5; ++i) {
+        std::this_thread::sleep_for(milliseconds(5));
+        real.wait_next(period);
+        check(Clock::now() >= real.next_deadline(), "wait_next waits for its deadline");
+    }
+    if (real.stats().restarts == 0) check(real.next_deadline() == first + 5 * period, "real waits on the grid");
+}
+
+int main() {
+    quantiles();
+    waits_and_histogram();
+    spin_only();
+    fixed_grid();
+    if (failures) return 1;
+    std::printf("frame_pacer: ok\n");
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "systems/greenhouse.h"
+#include "sim/Rng.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// The batched plot integrator against per-plot step(), bit for bit; stiff
+// plots against a tight-tolerance reference; harvest bookkeeping.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+namespace gh = mars::greenhouse;
+
+static bool bits_equal(double a, double b) { return std::memcmp(&a, &b, sizeof a) == 0; }
+
+static bool same(const gh::Totals& a, const gh::Totals& b) {
+    return bits_equal(a.o2Kg, b.o2Kg) && bits_equal(a.waterL, b.waterL) &&
+           bits_equal(a.harvestKg, b.harvestKg) && a.stiffPlots == b.stiffPlots && a.substeps == b.substeps;
+}
+
+struct Plots {
+    std::vector<double> b, w, light, q;
+    gh::PlotsSoA view() { return gh::PlotsSoA{b.data(), w.data(), light.data(), q.data()}; }
+};
+
+// A mix of healthy, dim and dried-out plots; n is deliberately not a
+// multiple of the block width.
+static Plots random_plots(sim::Rng& rng, size_t n) {
+    Plots p;
+    for (size_t i = 0; i < n; ++i) {
+        const bool dry = rng.uniform_u32(4) == 0;
+        p.b.push_back(0.5 + 19.0 * rng.uniform01());
+        p.w.push_back(dry ? 0.05 * rng.uniform01() : 10.0 * rng.uniform01());
+        p.light.push_back(rng.uniform01());
+        p.q.push_back(dry ? 0.0 : 0.5 * rng.uniform01());
+    }
+    return p;
+}
+
+static void batch_matches_step(sim::Rng& rng) {
+    const gh::Params par;
+    gh::Env env;
+    Plots batch = random_plots(rng, 1003);
+    Plots single = batch;
+    for (int hour = 0; hour < 48; ++hour) {
+        env.lightScale = hour % 7 == 0 ? 0.25 : 1.0;
+        const gh::Totals tb = gh::step_batch(batch.b.size(), batch.view(), env, par);
+        gh::Totals ts;
+        for (size_t i = 0; i < single.b.size(); ++i) {
+            gh::step(single.b[i], single.w[i], single.light[i], single.q[i], env, par, ts);
+        }
+        check(same(tb, ts), "batch totals bitwise");
+        bool plots = true;
+        for (size_t i = 0; i < batch.b.size(); ++i) {
+            plots = plots && bits_equal(batch.b[i], single.b[i]) && bits_equal(batch.w[i], single.w[i]);
+        }
+        check(plots, "batch plots bitwise");
+        if (failures) return;
+    }
+}
+
+static void irrigated_plots_are_cheap() {
+    const gh::Params par;
+    const gh::Env env;
+    Plots p;
+    for (int i = 0; i < 64; ++i) {
+        p.b.push_back(par.seedKg + 0.2 * i);
+        p.w.push_back(5.0);
+        p.light.push_back(1.0);
+        p.q.push_back(0.3);
+    }
+    gh::Totals sum;
+    for (int hour = 0; hour < 24 * 100; ++hour) {
+        const gh::Totals t = gh::step_batch(p.b.size(), p.view(), env, par);
+        sum.harvestKg += t.harvestKg;
+        sum.substeps += t.substeps;
+        check(t.o2Kg > 0.0 && t.waterL > 0.0, "growing plots make oxygen and draw water");
+    }
+    check(sum.substeps == 0, "irrigated plots take one step per tick");
+    check(sum.harvestKg > 0.0, "crops harvested");
+    for (size_t i = 0; i < p.b.size(); ++i) {
+        check(p.b[i] >= 0.0 && p.b[i] < par.harvestAtKg, "harvest cuts back below threshold");
+    }
+}
+
+static void stiff_plot_is_accurate() {
+    gh::Params par;
+    const gh::Env env;
+    // Big crop, nearly dry soil, no irrigation: the W equation is stiff.
+    double b = 18.0, w = 0.02;
+    gh::Totals t;
+    gh::step(b, w, 1.0, 0.0, env, par, t);
+    check(t.stiffPlots == 1 && t.substeps > 1, "dry plot sub-steps");
+
+    par.tolerance = 1e-10;
+    par.maxSubsteps = 1 << 16;
+    double rb = 18.0, rw = 0.02;
+    gh::Totals rt;
+    gh::step(rb, rw, 1.0, 0.0, env, par, rt);
+    check(std::abs(b - rb) < 1e-3 && std::abs(w - rw) < 1e-3, "stiff plot near reference");
+    check(std::abs(t.o2Kg - rt.o2Kg) < 1e-3, "stiff plot O2 near reference");
+    check(w >= 0.0, "soil water stays non-negative");
+}
+
+int main() {
+    sim::Rng rng(98);
+    batch_matches_step(rng);
+    irrigated_plots_are_cheap();
+    stiff_plot_is_accurate();
+    if (failures) return 1;
+    std::printf("greenhouse: ok\n");
+    return 0;
+}
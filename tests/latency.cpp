@@ -0,0 +1,66 @@
+#include "mars/latency.hpp"
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Bucket bounds, quantile accuracy, merging and concurrent recording.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+int main() {
+    using mars::LatencyHistogram;
+
+    // Every value lands in a bucket whose upper bound is within 1/kSub of it,
+    // and bucket indices never go backwards.
+    unsigned prev = 0;
+    for (uint64_t v = 0; v < (uint64_t{1} << 20); v += 1 + v / 64) {
+        const unsigned i = LatencyHistogram::index(v);
+        const uint64_t hi = LatencyHistogram::upper(i);
+        check(i >= prev, "index not monotonic");
+        check(hi >= v, "upper bound below value");
+        check(hi - v <= v / LatencyHistogram::kSub, "bucket wider than 1/kSub");
+        prev = i;
+    }
+    check(LatencyHistogram::index(~uint64_t{0}) == LatencyHistogram::kBuckets - 1, "overflow not clamped");
+
+    // Quantiles of 1..100000 ns.
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 100'000; ++v) h.record(v);
+    const auto near = [](uint64_t got, double want) {
+        const double g = static_cast<double>(got);
+        return g >= want && g <= want * (1.0 + 1.0 / LatencyHistogram::kSub);
+    };
+    check(h.count() == 100'000, "count");
+    check(h.max() == 100'000, "max");
+    check(near(h.quantile(0.50), 50'000), "p50");
+    check(near(h.quantile(0.99), 99'000), "p99");
+    check(near(h.quantile(0.999), 99'900), "p99.9");
+    check(h.quantile(1.0) == 100'000, "p100 is max");
+
+    // Merging two halves gives the same quantiles as recording everything.
+    LatencyHistogram a, b;
+    for (uint64_t v = 1; v <= 100'000; ++v) (v % 2 ? a : b).record(v);
+    a.merge(b);
+    check(a.count() == h.count() && a.max() == h.max(), "merge count/max");
+    for (double q : {0.1, 0.5, 0.9, 0.99, 0.999}) check(a.quantile(q) == h.quantile(q), "merge quantile");
+
+    // Per-thread shards: nothing lost under concurrent recording.
+    mars::LatencyMetric& m = mars::latency_metric("test.concurrent");
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < 8; ++t) {
+        threads.emplace_back([&m, t] {
+            for (uint64_t i = 0; i < 50'000; ++i) m.record(1000 + (i + t) % 977);
+        });
+    }
+    for (auto& t : threads) t.join();
+    const LatencyHistogram snap = m.snapshot();
+    check(snap.count() == 8 * 50'000, "concurrent records lost");
+    check(snap.max() == 1000 + 976, "concurrent max");
+    check(mars::latency_registry().report().find("test.concurrent") != std::string::npos, "report misses metric");
+
+    if (failures) return 1;
+    std::printf("latency: ok\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "sim/Pipeline.h"
+#include "sim/Recorder.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Per-tick bookkeeping through TickPipeline at depths 1 and 3 must see the
+// same checksums and replay stream as running it inline (depth 0), and a
+// slow consumer must hold the sim thread back at `depth` ticks.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+struct Run {
+    std::vector<std::pair<uint64_t, uint64_t>> checksums;  // (tick, checksum)
+    std::vector<std::pair<uint64_t, sim::Input>> replay;
+};
+
+static void bootstrap(sim::World& w) {
+    for (uint32_t i = 0; i < 64; ++i) {
+        w.colonists.push_back({i + 1, 20000 + static_cast<int32_t>(i) * 37, static_cast<int32_t>(i) * 11,
+                               static_cast<int32_t>(i) * 5, 293'000});
+    }
+    w.habitats.push_back({1, 50000, 101'325'000, 15'000});
+    w.habitats.push_back({2, 30000, 101'000'000, 9'000});
+}
+
+static Run run(unsigned depth, uint64_t ticks) {
+    sim::Simulation simulation(12345);
+    bootstrap(simulation.world());
+    sim::Recorder recorder;
+    Run out;
+    auto bookkeeping = [&](const sim::World& snap, uint64_t tick, const sim::Input& in) {
+        recorder.push(tick, in);
+        out.checksums.emplace_back(snap.tick, snap.checksum());
+    };
+    {
+        sim::TickPipeline pipeline(depth ? depth : 1, bookkeeping);
+        for (uint64_t t = 0; t < ticks; ++t) {
+            sim::Input in{};
+            in.example_command = static_cast<int32_t>(t % 7);
+            const sim::World& w = simulation.world();
+            const uint64_t tick = w.tick;
+            simulation.tick(in);
+            if (depth) pipeline.submit(w, tick, in);
+            else       bookkeeping(w, tick, in);
+        }
+        pipeline.finish();
+        check(pipeline.submitted() == (depth ? ticks : 0), "every tick submitted");
+    }
+    out.replay = recorder.events();
+    return out;
+}
+
+static bool same_replay(const Run& a, const Run& b) {
+    if (a.replay.size() != b.replay.size()) return false;
+    for (size_t i = 0; i < a.replay.size(); ++i) {
+        if (a.replay[i].first != b.replay[i].first ||
+            a.replay[i].second.example_command != b.replay[i].second.example_command) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void depths_agree() {
+    const uint64_t ticks = 400;
+    const Run inline0 = run(0, ticks);
+    check(inline0.checksums.size() == ticks && inline0.replay.size() == ticks, "inline bookkeeping ran");
+    for (unsigned depth : {1u, 3u}) {
+        const Run piped = run(depth, ticks);
+        check(piped.checksums == inline0.checksums, "checksums match inline");
+        check(same_replay(piped, inline0), "replay stream matches inline");
+    }
+}
+
+static void slow_consumer_backpressure() {
+    constexpr unsigned depth = 2;
+    std::atomic<uint64_t> consumed{0};
+    sim::World w;
+    bootstrap(w);
+    sim::TickPipeline pipeline(depth, [&](const sim::World&, uint64_t, const sim::Input&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        consumed.fetch_add(1);
+    });
+    uint64_t maxAhead = 0;
+    for (uint64_t t = 0; t < 20; ++t) {
+        w.tick = t + 1;
+        pipeline.submit(w, t, sim::Input{});
+        const uint64_t ahead = pipeline.submitted() - consumed.load();
+        maxAhead = ahead > maxAhead ? ahead : maxAhead;
+    }
+    check(pipeline.stalls() > 0, "slow consumer stalls submit");
+    check(maxAhead <= depth, "never more than depth ticks in flight");
+    pipeline.finish();
+    check(consumed.load() == 20, "finish drains");
+}
+
+int main() {
+    depths_agree();
+    slow_consumer_backpressure();
+    if (failures) return 1;
+    std::printf("pipeline: ok\n");
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include "systems/power_system.h"
+#include "sim/Rng.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// power::step_batch must match power::step bit for bit, in double and FP.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+static bool same_bits(double a, double b) { return std::memcmp(&a, &b, sizeof a) == 0; }
+
+using namespace mars::power;
+
+// Mostly random, with a share of the boundary cases each branch cares about.
+static double pick(sim::Rng& rng, double hi, double edge) {
+    switch (rng.uniform_u32(8)) {
+        case 0:  return 0.0;
+        case 1:  return edge;
+        default: return rng.uniform01() * hi;
+    }
+}
+
+static void batch_matches_scalar() {
+    sim::Rng rng(2024);
+    const Config cfg{0.92, 0.95, 0.5};
+
+    for (size_t n : {0u, 1u, 2u, 3u, 17u, 4096u, 4099u}) {
+        std::vector<double> stored(n), cap(n), prod(n), crit(n), noncrit(n), dt(n);
+        for (size_t i = 0; i < n; ++i) {
+            cap[i]     = 1000.0 + rng.uniform01() * 99'000.0;
+            stored[i]  = pick(rng, cap[i], cap[i]);
+            crit[i]    = pick(rng, 20'000.0, 5'000.0);
+            prod[i]    = pick(rng, 40'000.0, crit[i]);         // exactly covered
+            noncrit[i] = pick(rng, 20'000.0, prod[i] - crit[i]); // exactly served
+            dt[i]      = rng.uniform_u32(4) == 0 ? 1.0 : rng.uniform01() * 2.0;
+        }
+
+        std::vector<double> wantStored(n), eff(n), in(n), out(n), unmet(n);
+        std::vector<Result> want(n);
+        for (size_t i = 0; i < n; ++i) {
+            wantStored[i] = step(State{stored[i], cap[i]}, Inputs{prod[i], crit[i], noncrit[i], dt[i]},
+                                 cfg, want[i]).storedWh;
+        }
+
+        step_batch(n, StateSoA{stored.data(), cap.data()},
+                   InputsSoA{prod.data(), crit.data(), noncrit.data(), dt.data()}, cfg,
+                   ResultSoA{eff.data(), in.data(), out.data(), unmet.data()});
+
+        for (size_t i = 0; i < n; ++i) {
+            check(same_bits(stored[i], wantStored[i]),               "storedWh differs");
+            check(same_bits(eff[i],    want[i].nonCriticalEff),      "nonCriticalEff differs");
+            check(same_bits(in[i],     want[i].battInWh),            "battInWh differs");
+            check(same_bits(out[i],    want[i].battOutWh),           "battOutWh differs");
+            check(same_bits(unmet[i],  want[i].unmetCriticalWh),     "unmetCriticalWh differs");
+            if (failures) return;
+        }
+    }
+}
+
+// The fixed-point batch is integer-only, so it must match step<FP>() exactly,
+// and step<FP>() must stay close to the double step.
+static void fixed_batch_matches_scalar() {
+    sim::Rng rng(90);
+    const Config dcfg{0.92, 0.95, 0.5};
+    const FixedConfig cfg{FP::fromDouble(dcfg.etaIn), FP::fromDouble(dcfg.etaOut), FP::fromDouble(dcfg.cRate)};
+
+    for (size_t n : {0u, 1u, 5u, 4096u}) {
+        std::vector<FP> stored(n), cap(n), prod(n), crit(n), noncrit(n), dt(n);
+        for (size_t i = 0; i < n; ++i) {
+            const double c = 1000.0 + rng.uniform01() * 99'000.0;
+            const double cr = pick(rng, 20'000.0, 5'000.0);
+            const double p = pick(rng, 40'000.0, cr);
+            cap[i]     = FP::fromDouble(c);
+            stored[i]  = FP::fromDouble(pick(rng, c, c));
+            crit[i]    = FP::fromDouble(cr);
+            prod[i]    = FP::fromDouble(p);
+            noncrit[i] = FP::fromDouble(pick(rng, 20'000.0, p - cr));
+            dt[i]      = rng.uniform_u32(4) == 0 ? FP::fromInt(1) : FP::fromDouble(rng.uniform01() * 2.0);
+        }
+
+        std::vector<FP> wantStored(n), eff(n), in(n), out(n), unmet(n);
+        std::vector<FixedResult> want(n);
+        for (size_t i = 0; i < n; ++i) {
+            const FixedState s0{stored[i], cap[i]};
+            const FixedInputs x{prod[i], crit[i], noncrit[i], dt[i]};
+            wantStored[i] = step(s0, x, cfg, want[i]).storedWh;
+
+            // Against double: each FP op rounds by one ulp (2^-16), and the
+            // efficiencies themselves are rounded, a relative error on the flows.
+            Result d;
+            const State ds = step(State{stored[i].toDouble(), cap[i].toDouble()},
+                                  Inputs{prod[i].toDouble(), crit[i].toDouble(),
+                                         noncrit[i].toDouble(), dt[i].toDouble()}, dcfg, d);
+            const double tol = 0.01 + 2e-5 * (cap[i].toDouble() + d.battInWh + d.battOutWh);
+            check(std::fabs(wantStored[i].toDouble() - ds.storedWh) <= tol, "fixed storedWh far from double");
+            check(std::fabs(want[i].battInWh.toDouble() - d.battInWh) <= tol, "fixed battInWh far from double");
+            check(std::fabs(want[i].battOutWh.toDouble() - d.battOutWh) <= tol, "fixed battOutWh far from double");
+            if (failures) return;
+        }
+
+        step_batch(n, BasicStateSoA<FP>{stored.data(), cap.data()},
+                   BasicInputsSoA<FP>{prod.data(), crit.data(), noncrit.data(), dt.data()}, cfg,
+                   BasicResultSoA<FP>{eff.data(), in.data(), out.data(), unmet.data()});
+
+        for (size_t i = 0; i < n; ++i) {
+            check(stored[i] == wantStored[i],              "fixed storedWh differs");
+            check(eff[i]    == want[i].nonCriticalEff,     "fixed nonCriticalEff differs");
+            check(in[i]     == want[i].battInWh,           "fixed battInWh differs");
+            check(out[i]    == want[i].battOutWh,          "fixed battOutWh differs");
+            check(unmet[i]  == want[i].unmetCriticalWh,    "fixed unmetCriticalWh differs");
+            if (failures) return;
+        }
+    }
+}
+
+// Reference for step_n: n real steps, flagging the first one in which the
+// pack (not demand or the C-rate) limited a flow.
+struct Iterated {
+    State         state;
+    double        inWh = 0.0, outWh = 0.0, unmetWh = 0.0;
+    Crossing      crossing = Crossing::None;
+    std::uint64_t crossingStep = 0;
+};
+
+static Iterated iterate(State s, const Inputs& in, const Config& cfg, std::uint64_t n) {
+    const double prodWh = in.producersW * in.dtHours, critWh = in.criticalDemandW * in.dtHours;
+    const double nonCritWh = in.nonCriticalDemandW * in.dtHours;
+    const double maxWh = cfg.cRate * s.capacityWh * in.dtHours;
+    double drawWh = -1.0, storeWh = -1.0, availableWh = prodWh;
+    if (availableWh >= critWh) {
+        availableWh -= critWh;
+    } else {
+        drawWh = std::min((critWh - availableWh) / cfg.etaOut, maxWh);
+        availableWh += drawWh * cfg.etaOut;
+        availableWh = availableWh >= critWh ? availableWh - critWh : 0.0;
+    }
+    const double spareWh = availableWh - std::min(availableWh, nonCritWh);
+    if (spareWh > 1e-12) storeWh = std::min(spareWh * cfg.etaIn, maxWh * cfg.etaIn);
+
+    Iterated it;
+    for (std::uint64_t k = 1; k <= n; ++k) {
+        Crossing hit = Crossing::None;
+        if (drawWh >= 0.0 && s.storedWh < drawWh) hit = Crossing::Empty;
+        else if (storeWh >= 0.0 && std::max(0.0, s.capacityWh - s.storedWh) < storeWh) hit = Crossing::Full;
+        if (hit != Crossing::None && it.crossing == Crossing::None) { it.crossing = hit; it.crossingStep = k; }
+        Result r;
+        s = step(s, in, cfg, r);
+        it.inWh += r.battInWh; it.outWh += r.battOutWh; it.unmetWh += r.unmetCriticalWh;
+    }
+    it.state = s;
+    return it;
+}
+
+static void step_n_matches_iteration() {
+    sim::Rng rng(88);
+
+    // Dyadic values keep every operation exact, so step_n must agree exactly.
+    for (int t = 0; t < 400; ++t) {
+        const Config cfg{rng.uniform_u32(2) ? 1.0 : 0.5, rng.uniform_u32(2) ? 1.0 : 0.5,
+                         0.25 * (1 + rng.uniform_u32(4))};
+        const double cap = 1024.0 * (1 + rng.uniform_u32(16));
+        const State s0{static_cast<double>(rng.uniform_u32(static_cast<uint32_t>(cap) + 1)), cap};
+        const Inputs in{static_cast<double>(rng.uniform_u32(4000)), static_cast<double>(rng.uniform_u32(3000)),
+                        static_cast<double>(rng.uniform_u32(2000)), rng.uniform_u32(2) ? 1.0 : 0.5};
+        const std::uint64_t n = 1 + rng.uniform_u32(500);
+
+        const MultiStepResult got = step_n(s0, in, cfg, n);
+        const Iterated want = iterate(s0, in, cfg, n);
+        check(same_bits(got.state.storedWh, want.state.storedWh), "exact: storedWh");
+        check(got.crossing == want.crossing, "exact: crossing kind");
+        check(got.crossingStep == want.crossingStep, "exact: crossing step");
+        check(got.battInWh == want.inWh && got.battOutWh == want.outWh, "exact: totals");
+        if (failures) return;
+    }
+
+    // General values: the state and crossing still match bit for bit; only
+    // the totals round once per jump instead of once per step.
+    for (int t = 0; t < 2000; ++t) {
+        const Config cfg{0.8 + 0.2 * rng.uniform01(), 0.8 + 0.2 * rng.uniform01(), 0.05 + rng.uniform01()};
+        const double cap = 500.0 + rng.uniform01() * 50'000.0;
+        const State s0{pick(rng, cap, cap), cap};
+        const Inputs in{pick(rng, 8'000.0, 0.0), pick(rng, 6'000.0, 0.0), pick(rng, 3'000.0, 0.0),
+                        0.25 + rng.uniform01()};
+        const std::uint64_t n = 1 + rng.uniform_u32(20'000);
+
+        const MultiStepResult got = step_n(s0, in, cfg, n);
+        const Iterated want = iterate(s0, in, cfg, n);
+        const double tol = 1e-9 * cap;
+        check(same_bits(got.state.storedWh, want.state.storedWh), "storedWh");
+        check(got.crossing == want.crossing, "crossing kind");
+        check(got.crossingStep == want.crossingStep, "crossing step");
+        check(std::fabs(got.battOutWh - want.outWh) <= tol * static_cast<double>(n), "discharge total");
+        check(std::fabs(got.battInWh - want.inWh) <= tol * static_cast<double>(n), "charge total");
+        if (failures) return;
+    }
+
+    // Long drains and charges in small steps, through many binades and
+    // across the crossing, where one product per jump would drift.
+    for (int t = 0; t < 300; ++t) {
+        const Config cfg{0.8 + 0.2 * rng.uniform01(), 0.8 + 0.2 * rng.uniform01(), 1.0};
+        const double cap = 1e4 + rng.uniform01() * 1e6;
+        const bool drain = rng.uniform_u32(2) != 0;
+        const State s0{drain ? cap * (0.5 + 0.5 * rng.uniform01()) : cap * 0.5 * rng.uniform01(), cap};
+        const double flowW = cap * (0.5 + rng.uniform01()) / 10'000.0;   // ~10k steps end to end
+        const Inputs in{drain ? 0.0 : flowW, drain ? flowW : 0.0, 0.0, 1.0};
+        const std::uint64_t n = 2'000 + rng.uniform_u32(20'000);
+
+        const MultiStepResult got = step_n(s0, in, cfg, n);
+        const Iterated want = iterate(s0, in, cfg, n);
+        check(same_bits(got.state.storedWh, want.state.storedWh), "long run: storedWh");
+        check(got.crossing == want.crossing && got.crossingStep == want.crossingStep, "long run: crossing");
+        if (failures) return;
+    }
+}
+
+int main() {
+    batch_matches_scalar();
+    fixed_batch_matches_scalar();
+    step_n_matches_iteration();
+    if (failures) return 1;
+    std::printf("power_system: ok\n");
+    return 0;
+}
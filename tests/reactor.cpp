@@ -0,0 +1,104 @@
+#include "systems/reactor.h"
+#include <cmath>
+#include <cstdio>
+
+// Closed-form steady state, the sub-stepped transient against a
+// tight-tolerance reference, settling, and scram/restart.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+namespace rx = mars::reactor;
+
+static bool near(double a, double b, double tol) { return std::abs(a - b) <= tol; }
+
+// Advances hour by hour until settled; returns the hours taken, or -1.
+static int settle(rx::Core& c, const rx::Params& p, int maxHours) {
+    for (int h = 1; h <= maxHours; ++h) {
+        rx::advance(c, 1.0, p);
+        if (c.settled) return h;
+    }
+    return -1;
+}
+
+static void steady_state() {
+    const rx::Params p;
+    const rx::Core full = rx::steady(0.0, 1.0, p);
+    check(near(full.power, 1.0, 1e-12) && near(full.tempC, p.refC, 1e-9), "rated fixed point");
+    check(near(rx::output_kw(full, p), p.ratedKw, 1e-12), "rated output");
+    const rx::Core off = rx::steady(1.0, 1.0, p);
+    check(off.power == 0.0 && off.tempC == p.sinkC && rx::output_kw(off, p) == 0.0, "rods in: cold");
+
+    // A settled core costs nothing and stays put.
+    rx::Core c = full;
+    const rx::StepStats st = rx::advance(c, 1.0, p);
+    check(st.substeps == 0 && st.avgKw == rx::output_kw(full, p), "settled hour is free");
+    check(c.power == full.power && c.tempC == full.tempC, "settled core unchanged");
+}
+
+static void transient_accuracy() {
+    const rx::Params p;
+    rx::Params ref = p;
+    ref.tolerance = 1e-11;
+    ref.maxSubsteps = 1 << 20;
+
+    rx::Core a = rx::steady(0.0, 1.0, p), b = a;
+    rx::command_rods(a, 0.5);
+    rx::command_rods(b, 0.5);
+    check(!a.settled, "command starts a transient");
+    double ea = 0.0, eb = 0.0;
+    for (int h = 0; h < 6; ++h) {
+        const rx::StepStats sa = rx::advance(a, 1.0, p);
+        check(sa.substeps > 0 && !sa.tripped, "transient sub-steps");
+        ea += sa.avgKw;
+        eb += rx::advance(b, 1.0, ref).avgKw;
+    }
+    check(near(a.power, b.power, 1e-4) && near(a.rod, b.rod, 1e-4) && near(a.tempC, b.tempC, 0.05),
+          "transient near reference");
+    check(near(ea, eb, 1e-3), "energy near reference");
+
+    const int hours = settle(a, p, 100);
+    const rx::Core fixed = rx::steady(0.5, 1.0, p);
+    check(hours > 0 && a.power == fixed.power && a.tempC == fixed.tempC && a.rod == fixed.rod,
+          "settles onto the fixed point");
+    check(rx::advance(a, 1.0, p).substeps == 0, "and is free again");
+    check(rx::output_kw(a, p) < p.ratedKw && rx::output_kw(a, p) > 0.5 * p.ratedKw,
+          "temperature feedback softens a half insertion");
+}
+
+static void scram_and_restart() {
+    const rx::Params p;
+    rx::Core c = rx::steady(0.0, 1.0, p);
+    rx::set_cooling(c, 0.5);  // pumps damaged: the fixed point is above scramC
+    bool tripped = false;
+    double hottest = 0.0;
+    for (int h = 0; h < 24; ++h) {
+        tripped = rx::advance(c, 1.0, p).tripped || tripped;
+        hottest = c.tempC > hottest ? c.tempC : hottest;
+    }
+    check(tripped && c.scrammed, "loss of cooling trips");
+    check(hottest < p.scramC + 5.0, "trip caught at the limit");
+    check(settle(c, p, 100) > 0 && c.power == 0.0 && c.rod == 1.0, "scrammed core settles cold");
+    rx::command_rods(c, 0.0);
+    check(c.settled, "rods locked in while scrammed");
+
+    rx::Core hot = c;
+    hot.tempC = p.scramC;
+    check(!rx::reset_scram(hot, p), "no reset while hot");
+
+    rx::set_cooling(c, 1.0);
+    check(rx::reset_scram(c, p) && !c.scrammed && !c.settled, "reset");
+    bool retrip = false;
+    for (int h = 0; h < 100 && !c.settled; ++h) retrip = rx::advance(c, 1.0, p).tripped || retrip;
+    check(!retrip && c.settled && near(rx::output_kw(c, p), p.ratedKw, 1e-12), "cold restart to rated");
+}
+
+int main() {
+    steady_state();
+    transient_accuracy();
+    scram_and_restart();
+    if (failures) return 1;
+    std::printf("reactor: ok\n");
+    return 0;
+}
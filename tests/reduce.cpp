@@ -0,0 +1,71 @@
+#include "determinism/reduce.hpp"
+#include "sim/Rng.h"
+#include "sim/World.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Reductions must give the same bits for every thread count.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+static bool same_bits(double a, double b) { return std::memcmp(&a, &b, sizeof a) == 0; }
+
+int main() {
+    using namespace sim::det;
+    sim::Rng rng(77);
+
+    // Wide dynamic range so a reassociated sum would actually differ.
+    std::vector<double> v(100'003);
+    for (auto& x : v) {
+        const double mag = std::ldexp(1.0, rng.uniform_int(-40, 40));
+        x = (rng.uniform01() - 0.5) * mag;
+    }
+
+    const double tree1  = tree_sum(v.data(), v.size(), 1);
+    const double exact1 = exact_sum(v.data(), v.size(), 1);
+    for (unsigned t = 2; t <= 8; ++t) {
+        check(same_bits(tree_sum(v.data(), v.size(), t), tree1), "tree_sum differs across thread counts");
+        check(same_bits(exact_sum(v.data(), v.size(), t), exact1), "exact_sum differs across thread counts");
+    }
+
+    // Exact mode is also independent of element order.
+    std::vector<double> shuffled = v;
+    for (size_t i = shuffled.size() - 1; i > 0; --i) {
+        std::swap(shuffled[i], shuffled[rng.uniform_u32(static_cast<uint32_t>(i + 1))]);
+    }
+    check(same_bits(exact_sum(shuffled.data(), shuffled.size(), 3), exact1), "exact_sum depends on order");
+
+    // Catastrophic cancellation and subnormals.
+    const double cancel[] = { 1e100, 1.0, -1e100, 0x1p-1074, -0x1p-1074 };
+    check(exact_sum(cancel, 5) == 1.0, "exact_sum lost the 1.0 under cancellation");
+    const double tiny[] = { 0x1p-1074, 0x1p-1074, 0x1p-1070 };
+    check(exact_sum(tiny, 3) == 0x1p-1073 + 0x1p-1070, "exact_sum subnormals");
+    const double neg[] = { -0.1, -0.2, -0.3 };
+    check(exact_sum(neg, 3) == -0.6, "exact_sum negative");
+
+    // Integer mode for fixed-point raw values, including wrap-around.
+    std::vector<int64_t> iv(50'000);
+    for (auto& x : iv) x = static_cast<int64_t>(rng.next_u64());
+    const int64_t isum = int_sum(iv.data(), iv.size(), 1);
+    for (unsigned t = 2; t <= 8; ++t) {
+        check(int_sum(iv.data(), iv.size(), t) == isum, "int_sum differs across thread counts");
+    }
+
+    // World aggregates.
+    sim::World w;
+    for (uint32_t i = 0; i < 10'000; ++i) {
+        w.colonists.push_back({i, static_cast<int32_t>(i * 3), 0, static_cast<int32_t>(i % 1000), 293'000});
+    }
+    const auto t1 = w.totals(1), t4 = w.totals(4);
+    check(t1.oxygen_mg == t4.oxygen_mg && t1.stress_mil == t4.stress_mil, "World::totals differs across thread counts");
+    check(t1.oxygen_mg == 3LL * 9'999 * 10'000 / 2, "World::totals oxygen");
+    check(t1.avg_stress_mil == 499, "World::totals average stress");
+
+    if (failures) return 1;
+    std::printf("reduce: ok\n");
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include "../engine/script.hpp"
+#include "../engine/step.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Timeline waits and branches driven through stepHour(), far waits moving
+// from the overflow heap into the wheel at their exact hour, the
+// per-resume instruction budget, battery waits waking the hour the state
+// of charge drops under their threshold, and rebasing the clock on load.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+using namespace mars;
+
+struct Line { int hour; std::string text; };
+
+// Silent, deterministic hours; script Log lines are recorded with the hour
+// they ran in.
+static StepOpts recording(const GameState& s, std::vector<Line>& out) {
+    StepOpts opt;
+    opt.spawn_random_events = false;
+    opt.sink = [&s, &out](const LogMsg& m) {
+        if (m.kind == LogKind::Event) out.push_back(Line{s.hour, std::string(m.text)});
+    };
+    return opt;
+}
+
+static void waits_and_branches() {
+    GameState s;
+    initDefaultGame(s);
+    std::vector<Line> lines;
+    const StepOpts opt = recording(s, lines);
+
+    ScriptRunner run;
+    run.spawn(run.addProgram(Timeline().at_sol(2).log("a").wait_hours(5).log("b").build()), 0);
+    run.spawn(run.addProgram(Timeline()
+                                 .if_battery_below(0.99).log("low").end_if()
+                                 .if_battery_below(0.01).log("empty").end_if()
+                                 .log("done")
+                                 .build()),
+              3);
+    check(run.activeTasks() == 2, "spawned");
+    for (int h = 0; h < 60; ++h) stepHour(s, opt, &run);
+
+    check(lines.size() == 4, "four lines");
+    if (lines.size() == 4) {
+        check(lines[0].hour == 3 && lines[0].text == "low", "taken branch");
+        check(lines[1].hour == 3 && lines[1].text == "done", "skipped branch");
+        check(lines[2].hour == 2 * SOL_HOURS && lines[2].text == "a", "at_sol");
+        check(lines[3].hour == 2 * SOL_HOURS + 5 && lines[3].text == "b", "wait_hours");
+    }
+    check(run.activeTasks() == 0 && run.nextHour() == 60, "tasks finish");
+}
+
+static void far_waits() {
+    GameState s;
+    initDefaultGame(s);
+    std::vector<Line> lines;
+    const StepOpts opt = recording(s, lines);
+
+    // Hours beyond the wheel, several sharing a slot modulo kWheelSlots; the
+    // two at_sol(30) tasks share an hour and keep their spawn order.
+    ScriptRunner run;
+    std::vector<int> due;
+    for (int i = 0; i < 40; ++i) {
+        const int hour = ScriptRunner::kWheelSlots + 1 + (i * 37) % 400;
+        due.push_back(hour);
+        run.spawn(run.addProgram(Timeline().at_hour(hour).log(std::to_string(i)).build()), 0);
+    }
+    run.spawn(run.addProgram(Timeline().at_sol(30).log("sol30").build()), 0);
+    run.spawn(run.addProgram(Timeline().at_sol(30).log("sol30 second").build()), 0);
+
+    const int end = 30 * SOL_HOURS + 1;
+    bool exact = true;
+    for (int h = 0; h < end; ++h) {
+        const size_t before = lines.size();
+        stepHour(s, opt, &run);
+        for (size_t k = before; k < lines.size(); ++k) {
+            exact = exact && lines[k].hour == h;
+            if (lines[k].text.rfind("sol30", 0) == 0) continue;
+            exact = exact && due[static_cast<size_t>(std::stoi(lines[k].text))] == h;
+        }
+    }
+    check(exact, "far waits wake at their hour");
+    check(lines.size() == due.size() + 2, "every far wait ran once");
+    check(lines.size() >= 2 && lines[lines.size() - 2].text == "sol30" &&
+              lines.back().text == "sol30 second" && lines.back().hour == 30 * SOL_HOURS,
+          "at_sol(30) from the overflow heap, in spawn order");
+    check(run.activeTasks() == 0, "far tasks finish");
+}
+
+static void instruction_budget() {
+    GameState s;
+    initDefaultGame(s);
+    std::vector<Line> lines;
+    const StepOpts opt = recording(s, lines);
+
+    // A wait-less loop: Log, Jump back. Two instructions per line, so each
+    // hour's resume yields after kMaxInstrPerResume / 2 lines.
+    Program spin;
+    spin.text = {"spin"};
+    spin.code = {ScriptInstr{ScriptOp::Log, 0}, ScriptInstr{ScriptOp::Jump, 0, 0.0, 0}};
+    ScriptRunner run;
+    run.spawn(run.addProgram(spin), 0);
+    run.spawn(run.addProgram(Timeline().log("other").wait_hours(1).log("other").build()), 0);
+
+    for (int h = 0; h < 3; ++h) stepHour(s, opt, &run);
+    int perHour[3] = {0, 0, 0};
+    int other = 0;
+    for (const Line& l : lines) {
+        if (l.text == "other") { ++other; continue; }
+        if (l.hour >= 0 && l.hour < 3) ++perHour[l.hour];
+    }
+    const int expect = ScriptRunner::kMaxInstrPerResume / 2;
+    check(perHour[0] == expect && perHour[1] == expect && perHour[2] == expect, "yield after the budget");
+    check(other == 2, "a spinning task doesn't starve the others");
+    check(run.activeTasks() == 1, "spinner still parked");
+}
+
+static void battery_condition() {
+    GameState s;
+    initDefaultGame(s);
+    s.batteries = 1;
+    recomputePowerCapacity(s);
+    s.res.powerStored = s.res.powerCapKWh;
+    std::vector<Line> lines;
+    const StepOpts opt = recording(s, lines);
+
+    // runHour alone, so only the test moves the state of charge.
+    ScriptRunner run;
+    run.spawn(run.addProgram(Timeline().wait_battery_below(0.05).log("low").build()), 0);
+    run.spawn(run.addProgram(Timeline().wait_battery_below(0.5).log("half").build()), 0);
+    run.spawn(run.addProgram(Timeline().wait_battery_below(0.5).log("half second").build()), 0);
+    run.runHour(s, opt);
+    check(lines.empty() && run.activeTasks() == 3, "full pack waits");
+
+    // Under the higher threshold only: those wake, in spawn order.
+    s.hour = 1;
+    s.res.powerStored = 0.3 * s.res.powerCapKWh;
+    run.runHour(s, opt);
+    check(lines.size() == 2 && lines[0].text == "half" && lines[1].text == "half second", "threshold order");
+    check(run.activeTasks() == 1, "low threshold still parked");
+    lines.clear();
+
+    // A bank of new, empty modules: SoC drops at once, with no drain to
+    // estimate from.
+    s.hour = 2;
+    s.batteries += 30;
+    recomputePowerCapacity(s);
+    run.runHour(s, opt);
+    check(lines.size() == 1 && lines[0].hour == 2, "wakes the hour the SoC drops");
+    check(run.activeTasks() == 0, "condition task finishes");
+}
+
+static void rebase_on_load() {
+    GameState s;
+    initDefaultGame(s);
+    std::vector<Line> lines;
+    const StepOpts opt = recording(s, lines);
+
+    // A later save and an earlier one: either way the waits keep the 6 and
+    // 496 hours they had left at hour 4.
+    for (int base : {100, 2}) {
+        ScriptRunner run;
+        run.spawn(run.addProgram(Timeline().wait_hours(10).log("near").build()), 0);
+        run.spawn(run.addProgram(Timeline().at_hour(500).log("far").build()), 0);
+        for (s.hour = 0; s.hour < 4; ++s.hour) run.runHour(s, opt);
+
+        run.rebase(base);
+        check(run.nextHour() == base, "clock moved");
+        lines.clear();
+        for (s.hour = base; s.hour < base + 500; ++s.hour) run.runHour(s, opt);
+        check(lines.size() == 2, "both waits wake once");
+        if (lines.size() == 2) {
+            check(lines[0].text == "near" && lines[0].hour == base + 6, "near wait rebased");
+            check(lines[1].text == "far" && lines[1].hour == base + 496, "far wait rebased");
+        }
+    }
+}
+
+int main() {
+    waits_and_branches();
+    far_waits();
+    instruction_budget();
+    battery_condition();
+    rebase_on_load();
+    if (failures) return 1;
+    std::printf("script: ok\n");
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "sim/SimClock.h"
+#include <cstdio>
+#include <initializer_list>
+
+// Frame loop on a virtual wall clock: each frame costs a fixed render time
+// plus the measured cost of the steps it ran. With ticks too expensive for
+// the frame budget the backlog must stay bounded, Drop must discard the
+// debt and SlowDown must lower the effective speed instead.
+static int failures = 0;
+static void check(bool ok, const char* what) {
+    if (!ok) { std::printf("FAIL: %s\n", what); ++failures; }
+}
+
+static constexpr std::uint64_t kStepUs   = 10'000;  // 100 Hz
+static constexpr std::uint64_t kRenderUs = 16'000;
+static constexpr std::uint64_t kBudgetUs = 8'000;
+
+struct Outcome {
+    SimClockStats first;       // after warm-up
+    SimClockStats last;
+    std::uint64_t maxBacklog = 0;
+    std::uint64_t maxAccUs   = 0;
+    bool          withinBudget = true;  // never more steps than the budget
+};
+
+static Outcome run(LagPolicy policy, std::uint64_t tickCostUs, int frames) {
+    SimClock clock(kStepUs);
+    clock.set_frame_budget_us(kBudgetUs);
+    clock.set_lag_policy(policy);
+    Outcome out;
+    std::uint64_t frame = kRenderUs;
+    for (int f = 0; f < frames; ++f) {
+        clock.advance_by_frame_us(frame);
+        const SimClockStats& st = clock.stats();
+        if (f == frames / 2) out.first = st;
+        if (f > 20) {  // once the tick cost EWMA has converged
+            out.maxBacklog = st.backlog_ticks > out.maxBacklog ? st.backlog_ticks : out.maxBacklog;
+            out.maxAccUs   = clock.acc_us() > out.maxAccUs ? clock.acc_us() : out.maxAccUs;
+        }
+        std::uint32_t steps = 0;
+        while (clock.step_ready()) {
+            clock.consume_step(tickCostUs);
+            ++steps;
+        }
+        out.withinBudget = out.withinBudget && steps <= st.step_budget;
+        frame = kRenderUs + steps * tickCostUs;
+    }
+    out.last = clock.stats();
+    return out;
+}
+
+static double speed(std::uint32_t q16) { return q16 / 65536.0; }
+
+static void cheap_ticks_keep_up() {
+    for (LagPolicy p : {LagPolicy::Drop, LagPolicy::SlowDown}) {
+        const Outcome o = run(p, 100, 400);
+        check(o.last.dropped_us == 0, "cheap ticks drop nothing");
+        check(speed(o.last.effective_speed_q16) > 0.98 && speed(o.last.effective_speed_q16) < 1.02,
+              "cheap ticks run at 1x");
+    }
+}
+
+// 4 ms ticks: a 2-step budget per frame, but 16 ms render + 8 ms stepping
+// needs 2.4 steps a frame at 1x.
+static void drop_discards_debt() {
+    const Outcome o = run(LagPolicy::Drop, 4'000, 400);
+    check(o.withinBudget && o.last.step_budget == 2, "budget from measured tick cost");
+    check(o.maxBacklog <= o.last.step_budget, "backlog bounded by one frame's budget");
+    check(o.maxAccUs < (o.last.step_budget + 1) * kStepUs, "accumulator bounded");
+    check(o.first.dropped_us > 0 && o.last.dropped_us > o.first.dropped_us, "debt keeps being dropped");
+    // Every frame: 24 ms wall at 1x credits 24 ms, 20 ms are stepped.
+    const std::uint64_t frames = o.last.frames - o.first.frames;
+    const std::uint64_t perFrame = (o.last.dropped_us - o.first.dropped_us) / frames;
+    check(perFrame >= 3'900 && perFrame <= 4'100, "drops the unpayable 4 ms a frame");
+    check(o.last.requested_speed_q16 == 1u << 16, "Drop keeps the requested speed");
+}
+
+static void slowdown_lowers_speed() {
+    const Outcome o = run(LagPolicy::SlowDown, 4'000, 400);
+    check(o.withinBudget, "SlowDown stays within budget");
+    check(o.maxBacklog <= o.last.step_budget, "SlowDown backlog bounded");
+    check(o.last.dropped_us == o.first.dropped_us, "SlowDown drops nothing once settled");
+    // Sustainable: 2 steps of 10 ms per 24 ms frame.
+    const double eff = speed(o.last.effective_speed_q16);
+    check(eff > 0.80 && eff < 0.86, "effective speed falls to what the budget sustains");
+    check(o.last.requested_speed_q16 == 1u << 16, "request unchanged");
+}
+
+int main() {
+    cheap_ticks_keep_up();
+    drop_discards_debt();
+    slowdown_lowers_speed();
+    if (failures) return 1;
+    std::printf("sim_clock: ok\n");
+    return 0;
+}
@@ -8,6 +8,8 @@
 #include "../../engine/step.hpp"
 #include "../../engine/power.hpp"
 #include "../../engine/persist.hpp"
+#include "../../engine/script.hpp"
+#include "../../src/io/AsyncWriter.h"
 
 namespace mars::cli {
 
@@ -40,15 +42,15 @@ static void showStatus(const GameState& s) {
             << s.res.powerCapKWh << " kWh\n";
   std::cout << "Weather: "
             << (s.weather.dustStorm
-                ? "Dust storm (" + std::to_string(s.weather.dustStormHours) + "h left)"
+                ? "Dust storm (" + std::to_string(s.weather.dustStormHoursLeft(s.hour)) + "h left)"
                 : "Clear")
             << "\n";
 
   // Quick estimates for the current hour
-  double day = daylightFactor(s.hourOfSol()) *
-               (s.weather.dustStorm ? s.weather.solarMultiplier : 1.0);
-  double solarKW = s.solarPanels * SOLAR_PANEL_KW * day;
-  double critKW  = LIFE_SUPPORT_BASE_KW + s.colonists * CRIT_PER_COLONIST_KW;
+  double day = daylightFactor(s.hourOfSol());
+  double solarKW = s.modifiers.apply(Stat::SolarOutput, s.solarPanels * SOLAR_PANEL_KW * day);
+  double critKW  = s.modifiers.apply(Stat::CriticalLoad,
+                                     LIFE_SUPPORT_BASE_KW + s.colonists * CRIT_PER_COLONIST_KW);
   double nonKW   = s.labs * LAB_KW;
 
   std::cout << "Now (estimates): Gen " << solarKW << " kW, Critical "
@@ -63,11 +65,10 @@ static void showStatus(const GameState& s) {
   std::cout << "=====================\n\n";
 }
 
-static void doAdvance(GameState& s, int hours) {
+static void doAdvance(GameState& s, ScriptRunner& scripts, int hours) {
   StepOpts opt; // default: random events on, console sink
   for (int i = 0; i < hours; ++i) {
-    simulateHour(s, opt);
-    tickEffects(s, opt);
+    stepHour(s, opt, &scripts);
   }
 }
 
@@ -122,18 +123,20 @@ static void doForecast(GameState& s, int hours) {
   std::cout << "----------------------------------------------\n\n";
 }
 
-static void doSave(const GameState& s) {
+static void doSave(const GameState& s, io::AsyncWriter& checkpoints) {
   std::string path = "save.txt";
-  if (saveGame(s, path)) {
+  if (saveGame(s, checkpoints, path)) {
     std::cout << "Saved to " << path << "\n";
   } else {
     std::cout << "Failed to save.\n";
   }
 }
 
-static void doLoad(GameState& s) {
+static void doLoad(GameState& s, ScriptRunner& scripts, io::AsyncWriter& checkpoints) {
   std::string path = "save.txt";
+  checkpoints.drain(); // a save still in flight must land first
   if (loadGame(s, path)) {
+    scripts.rebase(s.hour); // waits keep their remaining hours
     std::cout << "Loaded from " << path << "\n";
   } else {
     std::cout << "Failed to load.\n";
@@ -145,6 +148,8 @@ static void doLoad(GameState& s) {
 int run() {
   GameState s;
   initDefaultGame(s, 42u); // deterministic seed by default
+  ScriptRunner scripts; // scenario tasks, resumed before each hour
+  io::AsyncWriter checkpoints; // saves are written in the background
 
   std::cout << "=== Mars Simulation (CLI) ===\n";
   bool running = true;
@@ -163,17 +168,18 @@ int run() {
 
     int c = readInt("Choice: ", 0, 7);
     switch (c) {
-      case 1: doAdvance(s, 1);  break;
-      case 2: doAdvance(s, 6);  break;
+      case 1: doAdvance(s, scripts, 1);  break;
+      case 2: doAdvance(s, scripts, 6);  break;
       case 3: doForecast(s, 24); break;
       case 4: doBuild(s);      break;
       case 5: showStatus(s);   break;
-      case 6: doSave(s);       break;
-      case 7: doLoad(s);       break;
+      case 6: doSave(s, checkpoints);  break;
+      case 7: doLoad(s, scripts, checkpoints);  break;
       case 0: running = false; break;
     }
   }
 
+  if (!checkpoints.drain()) std::cout << "A save failed to write.\n";
   std::cout << "Goodbye.\n";
   return 0;
 }